@@ -0,0 +1,39 @@
+from dynd import nd, ndt
+
+import matplotlib
+import matplotlib.pyplot
+
+from benchrun import Benchmark, median
+from benchtime import Timer
+
+nthreads = [1, 2, 4, 8, 16, 32]
+
+class ThreadedElwiseBenchmark(Benchmark):
+  parameters = ('nthreads',)
+  nthreads = nthreads
+
+  def __init__(self, func, size, grain = 0):
+    Benchmark.__init__(self)
+    self.func = func
+    self.size = size
+    self.grain = grain
+
+  @median
+  def run(self, nthreads):
+    # The outer dimension is split across the threads
+    f = nd.functional.elwise(self.func, nthreads = nthreads, grain = self.grain)
+
+    dst_tp = ndt.type('{} * 1000 * float64'.format(self.size // 1000))
+    a = nd.uniform(dst_tp = dst_tp)
+    b = nd.uniform(dst_tp = dst_tp)
+
+    with Timer() as timer:
+      f(a, b)
+
+    return timer.elapsed_time()
+
+if __name__ == '__main__':
+  benchmark = ThreadedElwiseBenchmark(nd.add, 10000000)
+  benchmark.plot_result(loglog = True)
+
+  matplotlib.pyplot.show()
@@ -0,0 +1,33 @@
+from dynd import nd, ndt
+
+import matplotlib
+import matplotlib.pyplot
+
+from benchrun import Benchmark, median
+from benchtime import Timer
+
+nthreads = [1, 2, 4, 8, 16]
+
+class ThreadedJSONBenchmark(Benchmark):
+  parameters = ('nthreads',)
+  nthreads = nthreads
+
+  def __init__(self, size):
+    Benchmark.__init__(self)
+    self.size = size
+    self.text = ''.join('{{"id": {0}, "name": "user{0}", "score": {1}}}\n'.format(i, i * 0.5)
+                        for i in range(size)).encode('utf-8')
+
+  @median
+  def run(self, nthreads):
+    # The text is split at line boundaries across the threads
+    with Timer() as timer:
+      nd.parse_json('var * {id: int64, name: string, score: float64}', self.text, nthreads = nthreads)
+
+    return timer.elapsed_time()
+
+if __name__ == '__main__':
+  benchmark = ThreadedJSONBenchmark(1000000)
+  benchmark.plot_result(loglog = True)
+
+  matplotlib.pyplot.show()
@@ -0,0 +1,79 @@
+from dynd import nd, ndt
+
+import matplotlib
+import matplotlib.pyplot
+
+from benchrun import Benchmark, median
+from benchtime import Timer
+
+size = [10, 100, 1000, 10000, 100000, 1000000, 10000000]
+
+class PyListBenchmark(Benchmark):
+  parameters = ('size',)
+  size = size
+
+  def __init__(self, make_list):
+    Benchmark.__init__(self)
+    self.make_list = make_list
+
+  @median
+  def run(self, size):
+    lst = self.make_list(size)
+
+    # Deduces the type and copies the values in a single pass
+    with Timer() as timer:
+      nd.array(lst)
+
+    return timer.elapsed_time()
+
+class TwoPassPyListBenchmark(Benchmark):
+  parameters = ('size',)
+  size = size
+
+  def __init__(self, make_list):
+    Benchmark.__init__(self)
+    self.make_list = make_list
+
+  @median
+  def run(self, size):
+    lst = self.make_list(size)
+
+    # Deduces the type in one pass, then copies the values in another
+    with Timer() as timer:
+      nd.array(lst, type = ndt.type_for(lst))
+
+    return timer.elapsed_time()
+
+class NumPyPyListBenchmark(Benchmark):
+  parameters = ('size',)
+  size = size
+
+  def __init__(self, make_list):
+    Benchmark.__init__(self)
+    self.make_list = make_list
+
+  @median
+  def run(self, size):
+    import numpy as np
+
+    lst = self.make_list(size)
+
+    with Timer() as timer:
+      np.array(lst)
+
+    return timer.elapsed_time()
+
+def float_list(size):
+  return [0.5 * i for i in range(size)]
+
+if __name__ == '__main__':
+  benchmark = PyListBenchmark(float_list)
+  benchmark.plot_result(loglog = True)
+
+  benchmark = TwoPassPyListBenchmark(float_list)
+  benchmark.plot_result(loglog = True)
+
+  benchmark = NumPyPyListBenchmark(float_list)
+  benchmark.plot_result(loglog = True)
+
+  matplotlib.pyplot.show()
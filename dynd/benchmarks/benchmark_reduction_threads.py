@@ -0,0 +1,39 @@
+from dynd import nd, ndt
+
+import matplotlib
+import matplotlib.pyplot
+
+from benchrun import Benchmark, median
+from benchtime import Timer
+
+# 0 is the single-threaded reduction, without the parallel wrapper
+nthreads = [0, 1, 2, 4, 8, 16, 32]
+
+class ThreadedReductionBenchmark(Benchmark):
+  parameters = ('nthreads',)
+  nthreads = nthreads
+
+  def __init__(self, func, size, grain = 0):
+    Benchmark.__init__(self)
+    self.func = func
+    self.size = size
+    self.grain = grain
+    self.a = nd.uniform(dst_tp = ndt.type('{} * float64'.format(size)))
+
+  @median
+  def run(self, nthreads):
+    f = self.func
+    if nthreads > 0:
+      # The outer dimension is split into blocks across the threads
+      f = nd.functional.parallel_reduction(self.func, nthreads = nthreads, grain = self.grain)
+
+    with Timer() as timer:
+      f(self.a)
+
+    return timer.elapsed_time()
+
+if __name__ == '__main__':
+  benchmark = ThreadedReductionBenchmark(nd.sum, 100000000)
+  benchmark.plot_result()
+
+  matplotlib.pyplot.show()
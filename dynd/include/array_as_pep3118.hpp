@@ -27,6 +27,20 @@ std::string make_pep3118_format(intptr_t &out_itemsize,
                                 const dynd::ndt::type &dt,
                                 const char *arrmeta = NULL);
 
+/**
+ * \brief Converts a PEP 3118 format string into a dynd type. This is the
+ *        inverse of make_pep3118_format for single items, so a subarray
+ *        like "(2,3)d" becomes a fixed_dim type. Struct formats are not
+ *        supported yet and raise a type_error.
+ *
+ * \param out_itemsize  Is filled with the size in bytes of one item.
+ * \param format  The format string, or NULL for unsigned bytes.
+ *
+ * \returns  The dynd type of one item.
+ */
+dynd::ndt::type make_type_from_pep3118_format(intptr_t &out_itemsize,
+                                              const char *format);
+
 /**
  * \brief Converts an nd::array into a PEP3118 buffer.
  */
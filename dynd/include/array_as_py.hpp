@@ -0,0 +1,33 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+// Converting numeric arrays into nested Python lists directly, without
+// going through an intermediate array of pyobject.
+//
+
+#pragma once
+
+#include <Python.h>
+
+#include <dynd/array.hpp>
+
+#include "visibility.hpp"
+
+namespace pydynd {
+
+/**
+ * Converts an array of bool, int, float or complex values, whose
+ * dimensions are all fixed, into nested Python lists. Each list is
+ * allocated at its final size and filled in a loop specialized for the
+ * element type. Returns a new reference to None if the array has any
+ * other type, so the caller can fall back to the general conversion.
+ *
+ * \param a  The array to convert.
+ * \param intern_values  If true, equal values share one Python object
+ *                       throughout the result, which saves allocations
+ *                       and memory for columns with few distinct values.
+ */
+PYDYND_API PyObject *array_as_numeric_pylist(const dynd::nd::array &a, bool intern_values);
+
+} // namespace pydynd
@@ -31,6 +31,31 @@ namespace pydynd {
  */
 PYDYND_API dynd::nd::array array_from_py(PyObject *obj, uint32_t access_flags, bool always_copy);
 
+/**
+ * Converts an object which exports the PEP 3118 buffer protocol into
+ * an nd::array. Unless a copy is requested, the result is a strided view
+ * of the exported memory, and the buffer stays acquired for as long as
+ * the view is alive.
+ *
+ * \param obj  The PyObject to view, e.g. a memoryview or array.array.
+ * \param access_flags Either 0 to inherit the buffer's access flags,
+ *                     or the access flags for the result.
+ * \param always_copy If this is set to true, a new copy is always
+ *                    created.
+ */
+PYDYND_API dynd::nd::array array_from_pep3118_buffer(PyObject *obj, uint32_t access_flags, bool always_copy);
+
+/**
+ * Converts a Python list of bool, int, float or complex values, nested
+ * to any depth but with a rectangular shape, into a strided nd::array.
+ * The type is deduced while the values are copied, so the list is only
+ * walked once. Returns a null array if the list holds anything else,
+ * or is ragged, so the caller can fall back to the general conversion.
+ *
+ * \param obj  A Python list.
+ */
+PYDYND_API dynd::nd::array array_from_numeric_pylist(PyObject *obj);
+
 void init_array_from_py();
 
 } // namespace pydynd
@@ -397,6 +397,47 @@ inline dynd::nd::array nd_fields(const dynd::nd::array &n, PyObject *field_list)
   return result;
 }
 
+/**
+ * Copies an array of structs, whose dimensions are all fixed, into a struct
+ * of arrays. Each field is stored as its own contiguous, C-order array, so
+ * accessing a field gives a view which steps through consecutive elements
+ * rather than over whole records.
+ */
+inline dynd::nd::array array_as_columnar(const dynd::nd::array &a)
+{
+  dynd::ndt::type fdt = a.get_dtype();
+  if (fdt.get_id() != dynd::struct_id) {
+    std::stringstream ss;
+    ss << "a columnar layout requires a dynd array of 'struct' kind, not " << fdt;
+    throw dynd::type_error(ss.str());
+  }
+  for (dynd::ndt::type tp = a.get_type(); tp.get_ndim() > 0;
+       tp = tp.extended<dynd::ndt::base_dim_type>()->get_element_type()) {
+    if (tp.get_id() != dynd::fixed_dim_id) {
+      std::stringstream ss;
+      ss << "a columnar layout requires fixed dimensions, not " << a.get_type();
+      throw dynd::type_error(ss.str());
+    }
+  }
+
+  const dynd::ndt::struct_type *bsd = fdt.extended<dynd::ndt::struct_type>();
+  intptr_t field_count = bsd->get_field_count();
+  std::vector<std::string> field_names(field_count);
+  std::vector<dynd::ndt::type> field_types(field_count);
+  for (intptr_t i = 0; i < field_count; ++i) {
+    const dynd::string &name = bsd->get_field_name(i);
+    field_names[i].assign(name.begin(), name.end());
+    field_types[i] = a.get_type().with_replaced_dtype(bsd->get_field_type(i));
+  }
+
+  // The default struct arrmeta lays the fields out one after another
+  dynd::nd::array result = dynd::nd::empty(dynd::ndt::make_type<dynd::ndt::struct_type>(field_names, field_types));
+  for (intptr_t i = 0; i < field_count; ++i) {
+    result.p(field_names[i]).assign(a.p(field_names[i]));
+  }
+  return result;
+}
+
 inline const char *array_access_flags_string(const dynd::nd::array &n)
 {
   if (n.is_null()) {
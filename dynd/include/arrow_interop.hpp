@@ -0,0 +1,117 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <Python.h>
+
+#include <stdint.h>
+
+#include <utility>
+
+#include <dynd/array.hpp>
+
+#include "visibility.hpp"
+
+// The Arrow C Data Interface, an ABI-stable description of columnar data.
+// These definitions are copied verbatim from the specification at
+// https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema {
+  // Array type description
+  const char *format;
+  const char *name;
+  const char *metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema *dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema *);
+  // Opaque producer-specific data
+  void *private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray *dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray *);
+  // Opaque producer-specific data
+  void *private_data;
+};
+
+} // extern "C"
+
+#endif // ARROW_C_DATA_INTERFACE
+
+namespace pydynd {
+
+/**
+ * Converts a 1D array of strings into the Arrow string layout, an
+ * offsets array of size N + 1 and a contiguous buffer of UTF-8 bytes,
+ * where string i is data[offsets[i]:offsets[i + 1]]. No Python objects
+ * are created, and both results export the buffer protocol.
+ *
+ * \param a  A 1D array of type "N * string".
+ * \param large_offsets  If true, the offsets are int64, otherwise int32,
+ *                       which raises an OverflowError if the data holds
+ *                       2 GiB or more.
+ *
+ * \returns  The pair (offsets, data).
+ */
+PYDYND_API std::pair<dynd::nd::array, dynd::nd::array> array_as_string_offsets(const dynd::nd::array &a,
+                                                                                bool large_offsets);
+
+/**
+ * Converts the Arrow string layout back into a 1D array of strings,
+ * copying each string out of the data buffer. The data is assumed
+ * to be valid UTF-8.
+ *
+ * \param offsets  A 1D array of int32 or int64 offsets, of size N + 1.
+ * \param data  A 1D contiguous array of uint8 or int8 bytes.
+ */
+PYDYND_API dynd::nd::array array_from_string_offsets(const dynd::nd::array &offsets, const dynd::nd::array &data);
+
+/**
+ * Exports an array through the Arrow C Data Interface, returning a new
+ * reference to a tuple of "arrow_schema" and "arrow_array" PyCapsules as
+ * specified by the Arrow PyCapsule Interface.
+ *
+ * The array must have an outermost fixed dimension, which becomes the
+ * Arrow array's length. Primitive types, bool, string, bytes, struct,
+ * var_dim (list), inner fixed_dim (fixed size list) and option (nulls)
+ * are supported. Primitive data which is contiguous is exported without
+ * copying, and the exported buffers keep the array alive.
+ */
+PYDYND_API PyObject *array_as_arrow_c_array(const dynd::nd::array &a);
+
+/**
+ * Imports an array from the Arrow C Data Interface, taking ownership of
+ * the ArrowArray in `array_capsule`. Primitive columns without nulls are
+ * viewed without copying, and keep the Arrow data alive. Columns with
+ * nulls become option types, whose data is copied because dynd marks
+ * missing values in place.
+ */
+PYDYND_API dynd::nd::array array_from_arrow_c_array(PyObject *schema_capsule, PyObject *array_capsule);
+
+} // namespace pydynd
@@ -0,0 +1,36 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <Python.h>
+
+#include <utility>
+
+#include <dynd/callable.hpp>
+
+#include "utility_functions.hpp"
+
+namespace pydynd {
+
+/**
+ * Calls the callable with the given positional and keyword arguments.
+ * If `release_gil` is true, the GIL is released for the duration of the
+ * call, so the caller must have checked that none of the types involved
+ * hold PyObject pointers. Kernels which call back into Python reacquire
+ * the GIL themselves via PyGILState_RAII.
+ */
+inline dynd::nd::array callable_call(dynd::nd::callable &f, size_t narg, dynd::nd::array *args, size_t nkwd,
+                                     std::pair<const char *, dynd::nd::array> *kwds, bool release_gil)
+{
+  if (release_gil) {
+    PyAllowThreads_RAII pat;
+    return f.call(narg, args, nkwd, kwds);
+  }
+
+  return f.call(narg, args, nkwd, kwds);
+}
+
+} // namespace pydynd
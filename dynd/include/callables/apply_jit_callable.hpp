@@ -4,6 +4,8 @@
 
 #include <dynd/callables/base_dispatch_callable.hpp>
 
+#include "utility_functions.hpp"
+
 namespace pydynd {
 namespace nd {
   namespace functional {
@@ -21,13 +23,13 @@ namespace nd {
       {
       }
 
-      dynd::ndt::type resolve(dynd::nd::base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), dynd::nd::call_graph &cg,
-                              const dynd::ndt::type &dst_tp, size_t DYND_UNUSED(nsrc),
-                              const dynd::ndt::type *DYND_UNUSED(src_tp), size_t DYND_UNUSED(nkwd),
-                              const dynd::nd::array *DYND_UNUSED(kwds),
-                              const std::map<std::string, dynd::ndt::type> &DYND_UNUSED(tp_vars))
+      dynd::ndt::type resolve(dynd::nd::base_callable *DYND_UNUSED(caller), char *data, dynd::nd::call_graph &cg,
+                              const dynd::ndt::type &dst_tp, size_t nsrc, const dynd::ndt::type *src_tp, size_t nkwd,
+                              const dynd::nd::array *kwds, const std::map<std::string, dynd::ndt::type> &tp_vars)
       {
-        return dst_tp;
+        const dynd::nd::callable &child = specialize(dst_tp, nsrc, src_tp);
+        return child->resolve(this, data, cg, dst_tp.is_symbolic() ? child->get_ret_type() : dst_tp, nsrc, src_tp,
+                              nkwd, kwds, tp_vars);
       }
 
       ~apply_jit_dispatch_callable()
@@ -44,25 +46,60 @@ namespace nd {
           key[i] = src_tp[i].get_id();
         }
 
+        // Compiling calls into Numba, and the call may have released the GIL
+        pydynd::PyGILState_RAII pgs;
+
         PyObject *&obj = children[key];
         if (obj == NULL) {
-
+          // The jit function returns a new reference, which the table keeps.
+          // It looks in the on-disk cache before compiling.
           obj = (*jit)(func, nsrc, src_tp);
-          if (PyErr_Occurred()) {
-            throw std::runtime_error("An exception was raised in Python");
+          if (obj == NULL) {
+            children.erase(key);
+            throw std::exception();
           }
-
-          Py_INCREF(obj);
         }
         return callable_to_cpp_ref(obj);
       }
     };
 
-    inline dynd::nd::callable apply_jit(const dynd::ndt::type &DYND_UNUSED(tp), intptr_t DYND_UNUSED(func))
+    /**
+     * Calls a compiled function with the signature of
+     * apply_jit_kernel::func_type, for one concrete type signature.
+     */
+    class apply_jit_callable : public dynd::nd::base_callable {
+      apply_jit_kernel::func_type m_func;
+
+    public:
+      apply_jit_callable(const dynd::ndt::type &tp, apply_jit_kernel::func_type func)
+          : dynd::nd::base_callable(tp), m_func(func)
+      {
+      }
+
+      dynd::ndt::type resolve(dynd::nd::base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data),
+                              dynd::nd::call_graph &cg, const dynd::ndt::type &DYND_UNUSED(dst_tp),
+                              size_t DYND_UNUSED(nsrc), const dynd::ndt::type *DYND_UNUSED(src_tp),
+                              size_t DYND_UNUSED(nkwd), const dynd::nd::array *DYND_UNUSED(kwds),
+                              const std::map<std::string, dynd::ndt::type> &DYND_UNUSED(tp_vars))
+      {
+        apply_jit_kernel::func_type func = m_func;
+        cg.emplace_back([func](dynd::nd::kernel_builder &kb, dynd::kernel_request_t kernreq, char *DYND_UNUSED(data),
+                               const char *DYND_UNUSED(dst_arrmeta), size_t nsrc,
+                               const char *const *DYND_UNUSED(src_arrmeta)) {
+          kb.emplace_back<apply_jit_kernel>(kernreq, nsrc, func);
+        });
+
+        return get_ret_type();
+      }
+    };
+
+    /**
+     * Makes a callable of type `tp` from the address of a compiled function.
+     * The caller keeps the code the address points into alive.
+     */
+    inline dynd::nd::callable apply_jit(const dynd::ndt::type &tp, intptr_t func)
     {
-      throw std::runtime_error("apply_jit is temporarily disabled");
-      //      return dynd::nd::make_callable<apply_jit_dispatch_callable>(
-      //        tp, nullptr, reinterpret_cast<apply_jit_kernel::func_type *>(func));
+      return dynd::nd::make_callable<apply_jit_callable>(tp, reinterpret_cast<apply_jit_kernel::func_type>(func));
     }
 
   } // namespace pydynd::nd::functional
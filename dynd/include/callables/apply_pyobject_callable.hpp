@@ -9,18 +9,48 @@ namespace nd {
     class apply_pyobject_callable : public dynd::nd::base_callable {
     public:
       PyObject *func;
+      // Call func once per strided() call with 1D views, instead of per element
+      bool batch;
 
-      apply_pyobject_callable(const dynd::ndt::type &tp, PyObject *func) : dynd::nd::base_callable(tp), func(func)
+      apply_pyobject_callable(const dynd::ndt::type &tp, PyObject *func, bool batch = false)
+          : dynd::nd::base_callable(tp), func(func), batch(batch)
       {
         Py_INCREF(func);
       }
 
       dynd::ndt::type resolve(dynd::nd::base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data),
-                              dynd::nd::call_graph &cg, const dynd::ndt::type &dst_tp, size_t DYND_UNUSED(nsrc),
-                              const dynd::ndt::type *DYND_UNUSED(src_tp), size_t DYND_UNUSED(nkwd),
+                              dynd::nd::call_graph &cg, const dynd::ndt::type &dst_tp, size_t nsrc,
+                              const dynd::ndt::type *src_tp, size_t DYND_UNUSED(nkwd),
                               const dynd::nd::array *DYND_UNUSED(kwds),
-                              const std::map<std::string, dynd::ndt::type> &DYND_UNUSED(tp_vars))
+                              const std::map<std::string, dynd::ndt::type> &tp_vars)
       {
+        dynd::ndt::type proto =
+            dynd::ndt::callable_type::make(dst_tp, std::vector<dynd::ndt::type>(src_tp, src_tp + nsrc));
+        PyObject *func = this->func;
+        bool batch = this->batch;
+
+        cg.emplace_back([proto, func, batch](dynd::nd::kernel_builder &kb, dynd::kernel_request_t kernreq,
+                                             char *DYND_UNUSED(data), const char *dst_arrmeta, size_t nsrc,
+                                             const char *const *src_arrmeta) {
+          pydynd::PyGILState_RAII pgs;
+
+          intptr_t ckb_offset = kb.size();
+          kb.emplace_back<apply_pyobject_kernel>(kernreq);
+          apply_pyobject_kernel *self = kb.get_at<apply_pyobject_kernel>(ckb_offset);
+          self->m_proto = proto;
+          self->m_pyfunc = func;
+          Py_XINCREF(self->m_pyfunc);
+          self->m_dst_arrmeta = dst_arrmeta;
+          self->m_src_arrmeta.assign(src_arrmeta, src_arrmeta + nsrc);
+          self->m_batch = batch;
+
+          // Assigns the python result of a single call to dst
+          kb(dynd::kernel_request_single, nullptr, dst_arrmeta, 1, nullptr);
+        });
+
+        dynd::ndt::type child_src_tp = dynd::ndt::make_type<pyobject_type>();
+        dynd::nd::assign->resolve(this, nullptr, cg, dst_tp, 1, &child_src_tp, 0, nullptr, tp_vars);
+
         return dst_tp;
       }
 
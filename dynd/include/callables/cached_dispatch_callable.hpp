@@ -0,0 +1,239 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/types/base_dim_type.hpp>
+#include <dynd/types/callable_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+namespace pydynd {
+namespace nd {
+  namespace functional {
+
+    /**
+     * Forwards each call to the first of its overloads whose positional
+     * argument types match those of the call. Unlike libdynd's
+     * multidispatch, the overloads aren't reordered by how specific they
+     * are, so more specific overloads have to come first.
+     *
+     * Matching the overloads one by one costs far more than a small
+     * kernel, so the overload picked for each combination of argument
+     * types is remembered. The key is built from the type ids of each
+     * argument's dimensions and dtype, which pins down the match as long
+     * as the dtype is builtin. The sizes of fixed dimensions are only
+     * added to the key when some overload asks for a particular size, so
+     * calls on arrays of many different lengths share entries. Calls with
+     * other arguments are matched every time. The cache is shared by all
+     * threads calling the callable, and counts its hits and misses for
+     * tuning.
+     */
+    class cached_dispatch_callable : public dynd::nd::base_callable {
+      // Start over once there are this many entries
+      static const size_t max_cache_size = 4096;
+
+      std::vector<dynd::nd::callable> m_overloads;
+      // Whether the sizes of fixed dimensions are part of the key
+      bool m_key_sizes;
+      std::mutex m_mutex;
+      std::map<std::vector<intptr_t>, size_t> m_cache;
+      std::atomic<int64_t> m_hits;
+      std::atomic<int64_t> m_misses;
+
+      /**
+       * Whether `tp` has a fixed dimension of a given size, rather than
+       * one matching any size.
+       */
+      static bool has_fixed_dim_size(dynd::ndt::type tp)
+      {
+        while (tp.get_base_id() == dynd::dim_kind_id) {
+          if (dynamic_cast<const dynd::ndt::fixed_dim_type *>(tp.extended()) != NULL) {
+            return true;
+          }
+          tp = tp.extended<dynd::ndt::base_dim_type>()->get_element_type();
+        }
+        return false;
+      }
+
+      static bool any_fixed_dim_size(const std::vector<dynd::nd::callable> &overloads)
+      {
+        for (size_t k = 0; k < overloads.size(); ++k) {
+          const dynd::ndt::callable_type *ct = overloads[k]->get_type().extended<dynd::ndt::callable_type>();
+          for (intptr_t i = 0; i < ct->get_npos(); ++i) {
+            if (has_fixed_dim_size(ct->get_pos_type(i))) {
+              return true;
+            }
+          }
+        }
+        return false;
+      }
+
+      bool make_key(size_t nsrc, const dynd::ndt::type *src_tp, std::vector<intptr_t> &out_key) const
+      {
+        for (size_t i = 0; i < nsrc; ++i) {
+          dynd::ndt::type tp = src_tp[i];
+          for (;;) {
+            out_key.push_back(tp.get_id());
+            if (tp.get_id() == dynd::fixed_dim_id) {
+              if (m_key_sizes) {
+                out_key.push_back(tp.extended<dynd::ndt::fixed_dim_type>()->get_fixed_dim_size());
+              }
+              tp = tp.extended<dynd::ndt::fixed_dim_type>()->get_element_type();
+            }
+            else if (tp.get_id() == dynd::var_dim_id) {
+              tp = tp.extended<dynd::ndt::var_dim_type>()->get_element_type();
+            }
+            else if (tp.is_builtin()) {
+              break;
+            }
+            else {
+              return false;
+            }
+          }
+        }
+        return true;
+      }
+
+      size_t find_overload(size_t nsrc, const dynd::ndt::type *src_tp) const
+      {
+        for (size_t k = 0; k < m_overloads.size(); ++k) {
+          const dynd::ndt::callable_type *ct =
+              m_overloads[k]->get_type().extended<dynd::ndt::callable_type>();
+          if (ct->get_npos() != static_cast<intptr_t>(nsrc)) {
+            continue;
+          }
+          std::map<std::string, dynd::ndt::type> tp_vars;
+          bool matched = true;
+          for (size_t i = 0; i < nsrc && matched; ++i) {
+            matched = ct->get_pos_type(i).match(src_tp[i], tp_vars);
+          }
+          if (matched) {
+            return k;
+          }
+        }
+
+        std::stringstream ss;
+        ss << "no overload of the callable matches the argument types (";
+        for (size_t i = 0; i < nsrc; ++i) {
+          ss << (i == 0 ? "" : ", ") << src_tp[i];
+        }
+        ss << ")";
+        throw std::invalid_argument(ss.str());
+      }
+
+    public:
+      cached_dispatch_callable(const dynd::ndt::type &tp, const std::vector<dynd::nd::callable> &overloads)
+          : dynd::nd::base_callable(tp), m_overloads(overloads), m_key_sizes(any_fixed_dim_size(overloads)),
+            m_hits(0), m_misses(0)
+      {
+      }
+
+      int64_t get_hits() const { return m_hits; }
+
+      int64_t get_misses() const { return m_misses; }
+
+      size_t get_cache_size()
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_cache.size();
+      }
+
+      void clear_cache()
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cache.clear();
+        m_hits = 0;
+        m_misses = 0;
+      }
+
+      dynd::ndt::type resolve(dynd::nd::base_callable *DYND_UNUSED(caller), char *data, dynd::nd::call_graph &cg,
+                              const dynd::ndt::type &dst_tp, size_t nsrc, const dynd::ndt::type *src_tp, size_t nkwd,
+                              const dynd::nd::array *kwds, const std::map<std::string, dynd::ndt::type> &tp_vars)
+      {
+        std::vector<intptr_t> key;
+        bool cacheable = make_key(nsrc, src_tp, key);
+        size_t k = m_overloads.size();
+        if (cacheable) {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          std::map<std::vector<intptr_t>, size_t>::const_iterator it = m_cache.find(key);
+          if (it != m_cache.end()) {
+            k = it->second;
+          }
+        }
+
+        if (k < m_overloads.size()) {
+          ++m_hits;
+        }
+        else {
+          ++m_misses;
+          k = find_overload(nsrc, src_tp);
+          if (cacheable) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_cache.size() >= max_cache_size) {
+              // Argument types seen long ago are likely gone, and dropping
+              // everything is cheaper than tracking which were used last
+              m_cache.clear();
+            }
+            m_cache[key] = k;
+          }
+        }
+
+        // The lock isn't held here, in case the overload calls back into
+        // this callable
+        return m_overloads[k]->resolve(this, data, cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+      }
+    };
+
+    /**
+     * Returns a callable of type `tp` which dispatches to `overloads`,
+     * remembering the overload picked for each argument types.
+     */
+    inline dynd::nd::callable cached_dispatch(const dynd::ndt::type &tp,
+                                              const std::vector<dynd::nd::callable> &overloads)
+    {
+      if (overloads.empty()) {
+        throw std::invalid_argument("a dispatching callable needs at least one overload");
+      }
+      return dynd::nd::make_callable<cached_dispatch_callable>(tp, overloads);
+    }
+
+    /**
+     * Reads the cache counters of a callable made by cached_dispatch,
+     * returning false if `f` is some other callable.
+     */
+    inline bool get_dispatch_stats(const dynd::nd::callable &f, int64_t *out_hits, int64_t *out_misses,
+                                   int64_t *out_size)
+    {
+      cached_dispatch_callable *cd = dynamic_cast<cached_dispatch_callable *>(f.get());
+      if (cd == NULL) {
+        return false;
+      }
+      *out_hits = cd->get_hits();
+      *out_misses = cd->get_misses();
+      *out_size = static_cast<int64_t>(cd->get_cache_size());
+      return true;
+    }
+
+    /**
+     * Empties the cache of a callable made by cached_dispatch and resets
+     * its counters, returning false if `f` is some other callable.
+     */
+    inline bool clear_dispatch_cache(const dynd::nd::callable &f)
+    {
+      cached_dispatch_callable *cd = dynamic_cast<cached_dispatch_callable *>(f.get());
+      if (cd == NULL) {
+        return false;
+      }
+      cd->clear_cache();
+      return true;
+    }
+
+  } // namespace pydynd::nd::functional
+} // namespace pydynd::nd
+} // namespace pydynd
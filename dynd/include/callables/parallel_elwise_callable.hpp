@@ -0,0 +1,92 @@
+#pragma once
+
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+#include "kernels/parallel_elwise_kernel.hpp"
+
+namespace pydynd {
+namespace nd {
+  namespace functional {
+
+    /**
+     * Wraps an elementwise callable so that calls whose arguments all have
+     * an outermost fixed dimension of the same size run that dimension on
+     * the thread pool. Any other call is passed straight to the child.
+     */
+    class parallel_elwise_callable : public dynd::nd::base_callable {
+      dynd::nd::callable m_child;
+      intptr_t m_nthreads;
+      intptr_t m_grain;
+
+    public:
+      parallel_elwise_callable(const dynd::nd::callable &child, intptr_t nthreads, intptr_t grain)
+          : dynd::nd::base_callable(child->get_type()), m_child(child), m_nthreads(nthreads), m_grain(grain)
+      {
+      }
+
+      dynd::ndt::type resolve(dynd::nd::base_callable *DYND_UNUSED(caller), char *data, dynd::nd::call_graph &cg,
+                              const dynd::ndt::type &dst_tp, size_t nsrc, const dynd::ndt::type *src_tp, size_t nkwd,
+                              const dynd::nd::array *kwds, const std::map<std::string, dynd::ndt::type> &tp_vars)
+      {
+        intptr_t dim_size = -1;
+        for (size_t i = 0; i < nsrc; ++i) {
+          if (src_tp[i].get_id() != dynd::fixed_dim_id ||
+              (dim_size >= 0 && src_tp[i].extended<dynd::ndt::fixed_dim_type>()->get_fixed_dim_size() != dim_size)) {
+            dim_size = -1;
+            break;
+          }
+          dim_size = src_tp[i].extended<dynd::ndt::fixed_dim_type>()->get_fixed_dim_size();
+        }
+        if (m_nthreads <= 1 || dim_size <= 1 ||
+            (dst_tp.get_id() == dynd::fixed_dim_id &&
+             dst_tp.extended<dynd::ndt::fixed_dim_type>()->get_fixed_dim_size() != dim_size)) {
+          return m_child->resolve(this, data, cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+        }
+
+        intptr_t nthreads = m_nthreads, grain = m_grain;
+        cg.emplace_back([nthreads, grain](dynd::nd::kernel_builder &kb, dynd::kernel_request_t kernreq,
+                                          char *DYND_UNUSED(data), const char *dst_arrmeta, size_t nsrc,
+                                          const char *const *src_arrmeta) {
+          const dynd::size_stride_t *dst_ss = reinterpret_cast<const dynd::size_stride_t *>(dst_arrmeta);
+          std::vector<intptr_t> src_stride(nsrc);
+          std::vector<const char *> child_src_arrmeta(nsrc);
+          for (size_t i = 0; i < nsrc; ++i) {
+            src_stride[i] = reinterpret_cast<const dynd::size_stride_t *>(src_arrmeta[i])->stride;
+            child_src_arrmeta[i] = src_arrmeta[i] + sizeof(dynd::size_stride_t);
+          }
+
+          kb.emplace_back<parallel_elwise_kernel>(kernreq, dst_ss->dim_size, dst_ss->stride, nsrc, src_stride.data(),
+                                                  nthreads, grain);
+          kb(dynd::kernel_request_strided, nullptr, dst_arrmeta + sizeof(dynd::size_stride_t), nsrc,
+             child_src_arrmeta.data());
+        });
+
+        std::vector<dynd::ndt::type> child_src_tp(nsrc);
+        for (size_t i = 0; i < nsrc; ++i) {
+          child_src_tp[i] = src_tp[i].extended<dynd::ndt::fixed_dim_type>()->get_element_type();
+        }
+        dynd::ndt::type child_dst_tp = dst_tp.get_id() == dynd::fixed_dim_id
+                                           ? dst_tp.extended<dynd::ndt::fixed_dim_type>()->get_element_type()
+                                           : dst_tp;
+        return dynd::ndt::make_fixed_dim(
+            dim_size, m_child->resolve(this, nullptr, cg, child_dst_tp, nsrc, child_src_tp.data(), nkwd, kwds, tp_vars));
+      }
+    };
+
+    /**
+     * Returns a callable which runs `child` with the outermost dimension
+     * split across `nthreads` threads, in chunks of `grain` elements. A
+     * grain of 0 picks one based on the dimension size.
+     */
+    inline dynd::nd::callable parallel_elwise(const dynd::nd::callable &child, intptr_t nthreads, intptr_t grain)
+    {
+      if (nthreads <= 0) {
+        nthreads = thread_pool::default_nthreads();
+      }
+      return dynd::nd::make_callable<parallel_elwise_callable>(child, nthreads, grain);
+    }
+
+  } // namespace pydynd::nd::functional
+} // namespace pydynd::nd
+} // namespace pydynd
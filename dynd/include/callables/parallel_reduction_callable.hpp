@@ -0,0 +1,103 @@
+#pragma once
+
+#include <memory>
+
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+#include "kernels/parallel_reduction_kernel.hpp"
+
+namespace pydynd {
+namespace nd {
+  namespace functional {
+
+    /**
+     * Wraps a reduction callable so that calls which reduce all of a
+     * single array of fixed dimensions to a builtin scalar are split into
+     * blocks on the thread pool. Any other call, including one given any
+     * keyword arguments, is passed straight to the child.
+     */
+    class parallel_reduction_callable : public dynd::nd::base_callable {
+      dynd::nd::callable m_child;
+      intptr_t m_nthreads;
+      intptr_t m_grain;
+
+      static bool is_fixed_builtin(const dynd::ndt::type &tp)
+      {
+        dynd::ndt::type el_tp = tp;
+        while (el_tp.get_id() == dynd::fixed_dim_id) {
+          el_tp = el_tp.extended<dynd::ndt::fixed_dim_type>()->get_element_type();
+        }
+        return el_tp.is_builtin();
+      }
+
+      static bool has_kwds(size_t nkwd, const dynd::nd::array *kwds)
+      {
+        for (size_t i = 0; i < nkwd; ++i) {
+          if (!kwds[i].is_null() && !kwds[i].is_missing()) {
+            return true;
+          }
+        }
+        return false;
+      }
+
+    public:
+      parallel_reduction_callable(const dynd::nd::callable &child, intptr_t nthreads, intptr_t grain)
+          : dynd::nd::base_callable(child->get_type()), m_child(child), m_nthreads(nthreads), m_grain(grain)
+      {
+      }
+
+      dynd::ndt::type resolve(dynd::nd::base_callable *DYND_UNUSED(caller), char *data, dynd::nd::call_graph &cg,
+                              const dynd::ndt::type &dst_tp, size_t nsrc, const dynd::ndt::type *src_tp, size_t nkwd,
+                              const dynd::nd::array *kwds, const std::map<std::string, dynd::ndt::type> &tp_vars)
+      {
+        if (m_nthreads <= 1 || nsrc != 1 || src_tp[0].get_id() != dynd::fixed_dim_id ||
+            src_tp[0].extended<dynd::ndt::fixed_dim_type>()->get_fixed_dim_size() <= 1 ||
+            !is_fixed_builtin(src_tp[0]) || has_kwds(nkwd, kwds)) {
+          return m_child->resolve(this, data, cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+        }
+
+        // The child's result type is only known once it has been resolved
+        // below, after this kernel's place in the call graph is taken
+        std::shared_ptr<dynd::ndt::type> child_dst_tp = std::make_shared<dynd::ndt::type>();
+        dynd::nd::callable child = m_child;
+        dynd::ndt::type src0_tp = src_tp[0];
+        intptr_t nthreads = m_nthreads, grain = m_grain;
+        cg.emplace_back([child, child_dst_tp, src0_tp, nthreads, grain](
+            dynd::nd::kernel_builder &kb, dynd::kernel_request_t kernreq, char *DYND_UNUSED(data),
+            const char *dst_arrmeta, size_t nsrc, const char *const *src_arrmeta) {
+          intptr_t ndim = src0_tp.get_ndim();
+          std::vector<intptr_t> shape(ndim), strides(ndim);
+          const dynd::size_stride_t *src_ss = reinterpret_cast<const dynd::size_stride_t *>(src_arrmeta[0]);
+          for (intptr_t i = 0; i < ndim; ++i) {
+            shape[i] = src_ss[i].dim_size;
+            strides[i] = src_ss[i].stride;
+          }
+
+          kb.emplace_back<parallel_reduction_kernel>(kernreq, child, src0_tp.get_dtype(), *child_dst_tp, ndim,
+                                                     shape.data(), strides.data(),
+                                                     child_dst_tp->is_builtin() ? nthreads : 1, grain);
+          kb(dynd::kernel_request_single, nullptr, dst_arrmeta, nsrc, src_arrmeta);
+        });
+
+        *child_dst_tp = m_child->resolve(this, data, cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+        return *child_dst_tp;
+      }
+    };
+
+    /**
+     * Returns a callable which runs the reduction `child` over blocks of
+     * `grain` rows of the outermost dimension on `nthreads` threads. A
+     * grain of 0 picks one based on the array size.
+     */
+    inline dynd::nd::callable parallel_reduction(const dynd::nd::callable &child, intptr_t nthreads, intptr_t grain)
+    {
+      if (nthreads <= 0) {
+        nthreads = thread_pool::default_nthreads();
+      }
+      return dynd::nd::make_callable<parallel_reduction_callable>(child, nthreads, grain);
+    }
+
+  } // namespace pydynd::nd::functional
+} // namespace pydynd::nd
+} // namespace pydynd
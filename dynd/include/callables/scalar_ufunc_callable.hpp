@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+
+#include <dynd/callables/base_callable.hpp>
+
+#include "kernels/numpy_ufunc.hpp"
+
+namespace pydynd {
+namespace nd {
+  namespace functional {
+
+    /**
+     * A callable for one inner loop of a NumPy ufunc, whose type is the
+     * loop's signature on scalars.
+     */
+    template <bool gil>
+    class scalar_ufunc_callable : public dynd::nd::base_callable {
+      std::shared_ptr<scalar_ufunc_data> m_data;
+      dynd::ndt::type m_dst_tp;
+
+    public:
+      scalar_ufunc_callable(const dynd::ndt::type &tp, const dynd::ndt::type &dst_tp,
+                            const std::shared_ptr<scalar_ufunc_data> &data)
+          : dynd::nd::base_callable(tp), m_data(data), m_dst_tp(dst_tp)
+      {
+      }
+
+      dynd::ndt::type resolve(dynd::nd::base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data),
+                              dynd::nd::call_graph &cg, const dynd::ndt::type &DYND_UNUSED(dst_tp),
+                              size_t DYND_UNUSED(nsrc), const dynd::ndt::type *DYND_UNUSED(src_tp),
+                              size_t DYND_UNUSED(nkwd), const dynd::nd::array *DYND_UNUSED(kwds),
+                              const std::map<std::string, dynd::ndt::type> &DYND_UNUSED(tp_vars))
+      {
+        // The call graph keeps the loop data alive for the kernels
+        std::shared_ptr<scalar_ufunc_data> data = m_data;
+        cg.emplace_back([data](dynd::nd::kernel_builder &kb, dynd::kernel_request_t kernreq,
+                               char *DYND_UNUSED(data), const char *DYND_UNUSED(dst_arrmeta),
+                               size_t DYND_UNUSED(nsrc), const char *const *DYND_UNUSED(src_arrmeta)) {
+          kb.emplace_back<scalar_ufunc_ck<gil>>(kernreq, data.get());
+        });
+
+        return m_dst_tp;
+      }
+    };
+
+  } // namespace pydynd::nd::functional
+} // namespace pydynd::nd
+} // namespace pydynd
@@ -0,0 +1,44 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+// Converting categorical arrays to and from integer codes plus a
+// categories array, the layout pandas.Categorical uses.
+//
+
+#pragma once
+
+#include <Python.h>
+
+#include <utility>
+
+#include <dynd/array.hpp>
+
+#include "visibility.hpp"
+
+namespace pydynd {
+
+/**
+ * Splits an array of categorical type into a read-only view of its
+ * integer codes, whose type is the categorical's storage type (uint8,
+ * uint16 or uint32), and a one-dimensional array of the categories, where
+ * code i stands for category i.
+ *
+ * \param a  An array whose dtype is categorical.
+ */
+PYDYND_API std::pair<dynd::nd::array, dynd::nd::array> array_as_categorical_codes(const dynd::nd::array &a);
+
+/**
+ * Makes a one-dimensional categorical array from integer codes and the
+ * one-dimensional array of unique categories they index. If the codes
+ * are read-only, contiguous and already of the categorical's storage type,
+ * the result is a read-only view of them, otherwise they are copied. Raises
+ * an error for any code outside [0, number of categories).
+ *
+ * \param codes  A one-dimensional array of integers.
+ * \param categories  A one-dimensional array of unique values.
+ */
+PYDYND_API dynd::nd::array array_from_categorical_codes(const dynd::nd::array &codes,
+                                                        const dynd::nd::array &categories);
+
+} // namespace pydynd
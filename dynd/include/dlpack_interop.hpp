@@ -0,0 +1,103 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <Python.h>
+
+#include <stdint.h>
+
+#include <dynd/array.hpp>
+
+#include "visibility.hpp"
+
+// The DLPack tensor ABI. These definitions follow dlpack.h from
+// https://github.com/dmlc/dlpack, and are skipped if it was included first.
+#ifndef DLPACK_DLPACK_H_
+#define DLPACK_DLPACK_H_
+
+extern "C" {
+
+typedef enum {
+  kDLCPU = 1,
+  kDLCUDA = 2,
+  kDLCUDAHost = 3,
+  kDLOpenCL = 4,
+  kDLVulkan = 7,
+  kDLMetal = 8,
+  kDLVPI = 9,
+  kDLROCM = 10,
+  kDLROCMHost = 11,
+  kDLExtDev = 12,
+  kDLCUDAManaged = 13,
+  kDLOneAPI = 14,
+  kDLWebGPU = 15,
+  kDLHexagon = 16,
+} DLDeviceType;
+
+typedef struct {
+  DLDeviceType device_type;
+  int32_t device_id;
+} DLDevice;
+
+typedef enum {
+  kDLInt = 0U,
+  kDLUInt = 1U,
+  kDLFloat = 2U,
+  kDLOpaqueHandle = 3U,
+  kDLBfloat = 4U,
+  kDLComplex = 5U,
+  kDLBool = 6U,
+} DLDataTypeCode;
+
+typedef struct {
+  uint8_t code;
+  uint8_t bits;
+  uint16_t lanes;
+} DLDataType;
+
+typedef struct {
+  void *data;
+  DLDevice device;
+  int32_t ndim;
+  DLDataType dtype;
+  int64_t *shape;
+  int64_t *strides;
+  uint64_t byte_offset;
+} DLTensor;
+
+typedef struct DLManagedTensor {
+  DLTensor dl_tensor;
+  void *manager_ctx;
+  void (*deleter)(struct DLManagedTensor *self);
+} DLManagedTensor;
+
+} // extern "C"
+
+#endif // DLPACK_DLPACK_H_
+
+namespace pydynd {
+
+/**
+ * Exports a strided array of a builtin numeric type as a DLPack
+ * "dltensor" PyCapsule on the CPU, without copying. The tensor keeps
+ * the array alive until the consumer calls its deleter.
+ *
+ * \param a  The array, whose dimensions must all be fixed_dim and whose
+ *           strides must be multiples of the element size.
+ *
+ * \returns  A new reference to the capsule.
+ */
+PYDYND_API PyObject *array_as_dlpack(const dynd::nd::array &a);
+
+/**
+ * Views the tensor in a DLPack "dltensor" PyCapsule as an array, without
+ * copying. This consumes the capsule, renaming it to "used_dltensor" as
+ * the protocol requires, and the array calls the tensor's deleter once
+ * it no longer references the data.
+ */
+PYDYND_API dynd::nd::array array_from_dlpack(PyObject *capsule);
+
+} // namespace pydynd
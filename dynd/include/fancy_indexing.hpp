@@ -0,0 +1,41 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+// Indexing an array's outermost dimension by an array of integer
+// indices or a boolean mask, as in NumPy's advanced indexing.
+//
+
+#pragma once
+
+#include <Python.h>
+
+#include <dynd/array.hpp>
+
+#include "visibility.hpp"
+
+namespace pydynd {
+
+/**
+ * Returns true if `index` is a 1D array of integers or bools, which
+ * array_take and array_put accept.
+ */
+PYDYND_API bool array_is_index_array(const dynd::nd::array &index);
+
+/**
+ * Gathers the rows of `a` selected by `index` along its outermost fixed
+ * dimension into a new array. An integer index may repeat or reorder
+ * rows and use negative indices, and a bool mask must have the size of
+ * the dimension.
+ */
+PYDYND_API dynd::nd::array array_take(const dynd::nd::array &a, const dynd::nd::array &index);
+
+/**
+ * Scatters `value` into the rows of `a` selected by `index`. If `value`
+ * has a row for each selected row, they are assigned in order, with the
+ * last one winning for repeated indices. Otherwise `value` is broadcast
+ * to every selected row.
+ */
+PYDYND_API void array_put(const dynd::nd::array &a, const dynd::nd::array &index, const dynd::nd::array &value);
+
+} // namespace pydynd
@@ -11,4 +11,9 @@
 
 #include "visibility.hpp"
 
-PYDYND_API dynd::nd::callable apply(const dynd::ndt::type &tp, PyObject *func);
+/**
+ * Makes a callable which calls the Python function `func`. If `batch` is
+ * true, lifted calls pass the function 1D views of whole strided runs of
+ * elements, rather than calling it once per element.
+ */
+PYDYND_API dynd::nd::callable apply(const dynd::ndt::type &tp, PyObject *func, bool batch = false);
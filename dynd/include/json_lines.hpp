@@ -0,0 +1,61 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+// Parsing newline-delimited JSON, one record per line, into the rows
+// of preallocated arrays.
+//
+
+#pragma once
+
+#include <Python.h>
+
+#include <dynd/array.hpp>
+
+#include "visibility.hpp"
+
+namespace pydynd {
+
+/**
+ * Parses the newline-delimited JSON records in [begin, end) into the
+ * rows of `out` starting at `start_row`, stopping when `out` is full or
+ * the text runs out. Blank lines are skipped.
+ *
+ * \param out  An array with an outermost fixed dimension, whose element
+ *             type is the type of one record.
+ * \param start_row  The first row of `out` to fill.
+ * \param begin  The start of the text.
+ * \param end  The end of the text.
+ * \param final  If false, a last line without a terminating newline is
+ *               treated as incomplete and left unparsed, so it can be
+ *               completed by the next block of a stream.
+ * \param out_consumed  Is filled with the number of bytes consumed.
+ *
+ * \returns  The number of rows parsed.
+ */
+PYDYND_API intptr_t parse_json_lines(const dynd::nd::array &out, intptr_t start_row, const char *begin,
+                                     const char *end, bool final, intptr_t *out_consumed);
+
+/**
+ * Parses the newline-delimited JSON records in [begin, end) on up to
+ * `nthreads` threads, returning an array of type `tp`, which must be
+ * "var * T" or "N * T" with one record of type T per line. The text is
+ * split at line boundaries into chunks, whose records are counted and
+ * then parsed in parallel into their own range of rows of the result.
+ *
+ * Records containing var dimensions are parsed on one thread, since
+ * their elements are allocated from memory shared by all the rows.
+ * The GIL is released while parsing.
+ */
+PYDYND_API dynd::nd::array parse_json_lines_parallel(const dynd::ndt::type &tp, const char *begin, const char *end,
+                                                     intptr_t nthreads);
+
+/**
+ * Like parse_json_lines_parallel, but parses into the rows of an existing
+ * array with an outermost fixed dimension, whose size must equal the
+ * number of records.
+ */
+PYDYND_API void parse_json_lines_parallel(const dynd::nd::array &out, const char *begin, const char *end,
+                                          intptr_t nthreads);
+
+} // namespace pydynd
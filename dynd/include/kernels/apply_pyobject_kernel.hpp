@@ -4,6 +4,7 @@
 #include <dynd/kernels/base_kernel.hpp>
 
 #include "array_conversions.hpp"
+#include "array_functions.hpp"
 #include "type_functions.hpp"
 #include "types/pyobject_type.hpp"
 
@@ -16,8 +17,11 @@ struct apply_pyobject_kernel : dynd::nd::base_strided_kernel<apply_pyobject_kern
   // The arrmeta
   const char *m_dst_arrmeta;
   std::vector<const char *> m_src_arrmeta;
+  // Whether the function is called once per strided() call with 1D
+  // views of the arguments, instead of once per element
+  bool m_batch;
 
-  apply_pyobject_kernel() : m_pyfunc(NULL) {}
+  apply_pyobject_kernel() : m_pyfunc(NULL), m_batch(false) {}
 
   ~apply_pyobject_kernel()
   {
@@ -65,9 +69,17 @@ struct apply_pyobject_kernel : dynd::nd::base_strided_kernel<apply_pyobject_kern
 
   void single(char *dst, char *const *src)
   {
+    // The kernel may be running with the GIL released
+    pydynd::PyGILState_RAII pgs;
+
+    if (m_batch) {
+      std::vector<intptr_t> src_stride(m_src_arrmeta.size(), 0);
+      strided(dst, 0, src, src_stride.data(), 1);
+      return;
+    }
+
     const dynd::ndt::callable_type *fpt = m_proto.extended<dynd::ndt::callable_type>();
     intptr_t nsrc = fpt->get_narg();
-    const dynd::ndt::type &dst_tp = fpt->get_return_type();
     const std::vector<dynd::ndt::type> &src_tp = fpt->get_argument_types();
     // First set up the parameters in a tuple
     pydynd::pyobject_ownref args(PyTuple_New(nsrc));
@@ -96,37 +108,51 @@ struct apply_pyobject_kernel : dynd::nd::base_strided_kernel<apply_pyobject_kern
   {
     const dynd::ndt::callable_type *fpt = m_proto.extended<dynd::ndt::callable_type>();
     intptr_t nsrc = fpt->get_narg();
+    pydynd::PyGILState_RAII pgs;
+
+    if (!m_batch) {
+      std::vector<char *> src_copy(src, src + nsrc);
+      for (size_t j = 0; j != count; ++j) {
+        single(dst, src_copy.data());
+        dst += dst_stride;
+        for (intptr_t i = 0; i != nsrc; ++i) {
+          src_copy[i] += src_stride[i];
+        }
+      }
+      return;
+    }
+
+    // In batch mode, the function sees each argument as a 1D strided
+    // view of all `count` elements, and returns all the results at once
     const dynd::ndt::type &dst_tp = fpt->get_return_type();
     const std::vector<dynd::ndt::type> &src_tp = fpt->get_argument_types();
-    // First set up the parameters in a tuple
+    intptr_t dim_size = static_cast<intptr_t>(count);
     pydynd::pyobject_ownref args(PyTuple_New(nsrc));
     for (intptr_t i = 0; i != nsrc; ++i) {
-      dynd::ndt::type tp = src_tp[i];
-      dynd::nd::array n = dynd::nd::make_array(tp, const_cast<char *>(src[i]), dynd::nd::read_access_flag);
+      char *el_arrmeta = NULL;
+      dynd::nd::array n =
+          dynd::nd::make_strided_array_from_data(src_tp[i], 1, &dim_size, &src_stride[i], dynd::nd::read_access_flag,
+                                                 src[i], dynd::nd::memory_block(), &el_arrmeta);
       if (src_tp[i].get_arrmeta_size() > 0) {
-        src_tp[i].extended()->arrmeta_copy_construct(n.get()->metadata(), m_src_arrmeta[i], dynd::nd::memory_block());
+        src_tp[i].extended()->arrmeta_copy_construct(el_arrmeta, m_src_arrmeta[i], dynd::nd::memory_block());
       }
       PyTuple_SET_ITEM(args.get(), i, pydynd::array_from_cpp(std::move(n)));
     }
-    // Do the loop, reusing the args we created
-    for (size_t j = 0; j != count; ++j) {
-      // Call the function
-      pydynd::pyobject_ownref res(PyObject_Call(m_pyfunc, args.get(), NULL));
-      // Copy the result into the destination memory
-      PyObject *child_obj = res.get();
-      char *child_src = reinterpret_cast<char *>(&child_obj);
-      get_child()->single(dst, &child_src);
-      res.clear();
-      // Validate that the call didn't hang onto the ephemeral data
-      // pointers we used. This is done after the dst assignment, because
-      // the function result may have contained a reference to an argument.
-      verify_postcall_consistency(args.get());
-      // Increment to the next one
-      dst += dst_stride;
-      for (intptr_t i = 0; i != nsrc; ++i) {
-        const dynd::nd::array &n = pydynd::array_to_cpp_ref(PyTuple_GET_ITEM(args.get(), i));
-//        n->set_data(n->get_data() + src_stride[i]);
+    pydynd::pyobject_ownref res(PyObject_Call(m_pyfunc, args.get(), NULL));
+
+    // Copy the results into a view of the destination memory, which
+    // also broadcasts a scalar result
+    {
+      char *el_arrmeta = NULL;
+      dynd::nd::array dst_view = dynd::nd::make_strided_array_from_data(
+          dst_tp, 1, &dim_size, &dst_stride, dynd::nd::read_access_flag | dynd::nd::write_access_flag, dst,
+          dynd::nd::memory_block(), &el_arrmeta);
+      if (dst_tp.get_arrmeta_size() > 0) {
+        dst_tp.extended()->arrmeta_copy_construct(el_arrmeta, m_dst_arrmeta, dynd::nd::memory_block());
       }
+      dst_view.assign(pydynd::pyobject_array(res.get()));
     }
+    res.clear();
+    verify_postcall_consistency(args.get());
   }
 };
@@ -225,9 +225,125 @@ void pyint_to_int(dynd::uint128 *out, PyObject *obj)
   *out = result;
 }
 
+inline bool is_exact_pyint_type(PyTypeObject *tp)
+{
+#if PY_VERSION_HEX < 0x03000000
+  if (tp == &PyInt_Type) {
+    return true;
+  }
+#endif
+  return tp == &PyLong_Type;
+}
+
+/**
+ * Reads a Python object whose exact type is int into a C long long,
+ * returning false if it doesn't fit. Ints which fit in a single digit
+ * are read straight out of the object where the CPython API allows it.
+ */
+inline bool pyint_exact_as_longlong(PyTypeObject *tp, PyObject *obj, long long &out)
+{
+#if PY_VERSION_HEX < 0x03000000
+  if (tp == &PyInt_Type) {
+    out = PyInt_AS_LONG(obj);
+    return true;
+  }
+#else
+  (void)tp;
+#endif
+#if PY_VERSION_HEX >= 0x030C0000
+  if (PyUnstable_Long_IsCompact(reinterpret_cast<PyLongObject *>(obj))) {
+    out = PyUnstable_Long_CompactValue(reinterpret_cast<PyLongObject *>(obj));
+    return true;
+  }
+#endif
+  int overflow;
+  out = PyLong_AsLongLongAndOverflow(obj, &overflow);
+  return overflow == 0;
+}
+
+template <typename T>
+std::enable_if_t<is_signed_integral<T>::value && sizeof(T) <= sizeof(long long), bool>
+assign_exact_pyint(PyTypeObject *tp, T *out, PyObject *obj)
+{
+  long long v;
+  if (!pyint_exact_as_longlong(tp, obj, v)) {
+    return false;
+  }
+  *out = static_cast<T>(v);
+  return true;
+}
+
+template <typename T>
+std::enable_if_t<is_unsigned_integral<T>::value && sizeof(T) <= sizeof(long long), bool>
+assign_exact_pyint(PyTypeObject *tp, T *out, PyObject *obj)
+{
+  long long v;
+  if (!pyint_exact_as_longlong(tp, obj, v) || v < 0 ||
+      static_cast<unsigned long long>(v) > std::numeric_limits<T>::max()) {
+    // Leave the error reporting to the general path
+    return false;
+  }
+  *out = static_cast<T>(v);
+  return true;
+}
+
+// The 128-bit integers always take the general path
+template <typename T>
+std::enable_if_t<(sizeof(T) > sizeof(long long)), bool> assign_exact_pyint(PyTypeObject *DYND_UNUSED(tp),
+                                                                          T *DYND_UNUSED(out),
+                                                                          PyObject *DYND_UNUSED(obj))
+{
+  return false;
+}
+
+/**
+ * The strided loop shared by the numeric kernels. The exact Python type
+ * of the first object in a run is checked once, and as long as the
+ * objects that follow have that same type the kernel's assign_exact is
+ * used for them, which skips the generic type checks. Anything else,
+ * including values assign_exact turns down, goes through single().
+ */
+template <typename SelfType>
+void strided_from_pyobject(SelfType *self, char *dst, intptr_t dst_stride, char *src0, intptr_t src0_stride,
+                           size_t count)
+{
+  for (size_t i = 0; i != count;) {
+    PyObject *src_obj = *reinterpret_cast<PyObject *const *>(src0);
+    PyTypeObject *run_tp = Py_TYPE(src_obj);
+    if (SelfType::is_exact_type(run_tp)) {
+      while (SelfType::assign_exact(run_tp, dst, src_obj)) {
+        dst += dst_stride;
+        src0 += src0_stride;
+        if (++i == count) {
+          return;
+        }
+        src_obj = *reinterpret_cast<PyObject *const *>(src0);
+        if (Py_TYPE(src_obj) != run_tp) {
+          break;
+        }
+      }
+      if (Py_TYPE(src_obj) != run_tp) {
+        // A new run starts here
+        continue;
+      }
+    }
+    self->single(dst, &src0);
+    dst += dst_stride;
+    src0 += src0_stride;
+    ++i;
+  }
+}
+
 template <typename ReturnType>
 struct assign_from_pyobject_kernel<ReturnType, std::enable_if_t<is_signed_integral<ReturnType>::value>>
     : dynd::nd::base_strided_kernel<assign_from_pyobject_kernel<ReturnType>, 1> {
+  static bool is_exact_type(PyTypeObject *tp) { return is_exact_pyint_type(tp); }
+
+  static bool assign_exact(PyTypeObject *tp, char *dst, PyObject *obj)
+  {
+    return assign_exact_pyint(tp, reinterpret_cast<ReturnType *>(dst), obj);
+  }
+
   void single(char *dst, char *const *src)
   {
     PyObject *src_obj = *reinterpret_cast<PyObject *const *>(src[0]);
@@ -257,11 +373,23 @@ struct assign_from_pyobject_kernel<ReturnType, std::enable_if_t<is_signed_integr
       *reinterpret_cast<ReturnType *>(dst) = static_cast<ReturnType>(value);
     }
   }
+
+  void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count)
+  {
+    strided_from_pyobject(this, dst, dst_stride, src[0], src_stride[0], count);
+  }
 };
 
 template <typename ReturnType>
 struct assign_from_pyobject_kernel<ReturnType, std::enable_if_t<is_unsigned_integral<ReturnType>::value>>
     : dynd::nd::base_strided_kernel<assign_from_pyobject_kernel<ReturnType>, 1> {
+  static bool is_exact_type(PyTypeObject *tp) { return is_exact_pyint_type(tp); }
+
+  static bool assign_exact(PyTypeObject *tp, char *dst, PyObject *obj)
+  {
+    return assign_exact_pyint(tp, reinterpret_cast<ReturnType *>(dst), obj);
+  }
+
   void single(char *dst, char *const *src)
   {
     PyObject *src_obj = *reinterpret_cast<PyObject *const *>(src[0]);
@@ -276,11 +404,33 @@ struct assign_from_pyobject_kernel<ReturnType, std::enable_if_t<is_unsigned_inte
       *reinterpret_cast<ReturnType *>(dst) = pydynd::array_from_py(src_obj, 0, false).as<ReturnType>();
     }
   }
+
+  void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count)
+  {
+    strided_from_pyobject(this, dst, dst_stride, src[0], src_stride[0], count);
+  }
 };
 
 template <typename ReturnType>
 struct assign_from_pyobject_kernel<ReturnType, std::enable_if_t<is_floating_point<ReturnType>::value>>
     : nd::base_strided_kernel<assign_from_pyobject_kernel<ReturnType>, 1> {
+  static bool is_exact_type(PyTypeObject *tp) { return tp == &PyFloat_Type || is_exact_pyint_type(tp); }
+
+  static bool assign_exact(PyTypeObject *tp, char *dst, PyObject *obj)
+  {
+    if (tp == &PyFloat_Type) {
+      *reinterpret_cast<ReturnType *>(dst) = static_cast<ReturnType>(PyFloat_AS_DOUBLE(obj));
+      return true;
+    }
+
+    long long v;
+    if (!pyint_exact_as_longlong(tp, obj, v)) {
+      return false;
+    }
+    *reinterpret_cast<ReturnType *>(dst) = static_cast<ReturnType>(v);
+    return true;
+  }
+
   void single(char *dst, char *const *src)
   {
     PyObject *src_obj = *reinterpret_cast<PyObject *const *>(src[0]);
@@ -295,6 +445,11 @@ struct assign_from_pyobject_kernel<ReturnType, std::enable_if_t<is_floating_poin
       *reinterpret_cast<ReturnType *>(dst) = pydynd::array_from_py(src_obj, 0, false).as<ReturnType>();
     }
   }
+
+  void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count)
+  {
+    strided_from_pyobject(this, dst, dst_stride, src[0], src_stride[0], count);
+  }
 };
 
 template <typename ReturnType>
@@ -303,6 +458,36 @@ struct assign_from_pyobject_kernel<ReturnType, std::enable_if_t<is_complex<Retur
   typedef ReturnType U;
   typedef typename U::value_type T;
 
+  static bool is_exact_type(PyTypeObject *tp)
+  {
+    return tp == &PyComplex_Type || tp == &PyFloat_Type || is_exact_pyint_type(tp);
+  }
+
+  static bool assign_exact(PyTypeObject *tp, char *dst, PyObject *obj)
+  {
+    if (tp == &PyComplex_Type) {
+      const Py_complex &v = reinterpret_cast<PyComplexObject *>(obj)->cval;
+      reinterpret_cast<T *>(dst)[0] = static_cast<T>(v.real);
+      reinterpret_cast<T *>(dst)[1] = static_cast<T>(v.imag);
+      return true;
+    }
+
+    double v;
+    if (tp == &PyFloat_Type) {
+      v = PyFloat_AS_DOUBLE(obj);
+    }
+    else {
+      long long iv;
+      if (!pyint_exact_as_longlong(tp, obj, iv)) {
+        return false;
+      }
+      v = static_cast<double>(iv);
+    }
+    reinterpret_cast<T *>(dst)[0] = static_cast<T>(v);
+    reinterpret_cast<T *>(dst)[1] = 0;
+    return true;
+  }
+
   void single(char *dst, char *const *src)
   {
     PyObject *src_obj = *reinterpret_cast<PyObject *const *>(src[0]);
@@ -318,6 +503,11 @@ struct assign_from_pyobject_kernel<ReturnType, std::enable_if_t<is_complex<Retur
       *reinterpret_cast<dynd::complex<T> *>(dst) = pydynd::array_from_py(src_obj, 0, false).as<dynd::complex<T>>();
     }
   }
+
+  void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count)
+  {
+    strided_from_pyobject(this, dst, dst_stride, src[0], src_stride[0], count);
+  }
 };
 
 template <>
@@ -574,20 +764,162 @@ struct assign_from_pyobject_kernel<dynd::ndt::tuple_type>
   }
 };
 
-// TODO: Should make a more efficient strided kernel function
+/**
+ * Assigns from dicts by looking up each key's field once and copying the
+ * values a column at a time. The field of each key is cached by its
+ * position in the dict, so rows built the same way, whose keys are the
+ * same (typically interned) string objects in the same order, are matched
+ * by pointer comparisons alone. Other keys are looked up by hash in a dict
+ * from field name to index, rather than by converting them to strings.
+ */
 template <>
 struct assign_from_pyobject_kernel<dynd::ndt::struct_type>
     : dynd::nd::base_strided_kernel<assign_from_pyobject_kernel<dynd::ndt::struct_type>, 1> {
+  // The number of dicts whose values are gathered before copying them
+  static const intptr_t block_size = 256;
+
   dynd::ndt::type m_dst_tp;
   const char *m_dst_arrmeta;
   bool m_dim_broadcast;
   std::vector<intptr_t> m_copy_el_offsets;
+  // Maps field names to their indices, created on first use
+  PyObject *m_field_indices;
+  // The keys last seen at each dict position, and the fields they map to
+  std::vector<PyObject *> m_cached_keys;
+  std::vector<intptr_t> m_cached_fields;
+  // The gathered values, field_count columns of block_size rows each
+  std::vector<PyObject *> m_values;
+
+  assign_from_pyobject_kernel() : m_field_indices(NULL) {}
 
   ~assign_from_pyobject_kernel()
   {
     for (size_t i = 0; i < m_copy_el_offsets.size(); ++i) {
       get_child(m_copy_el_offsets[i])->destroy();
     }
+    Py_XDECREF(m_field_indices);
+    for (size_t i = 0; i < m_cached_keys.size(); ++i) {
+      Py_XDECREF(m_cached_keys[i]);
+    }
+  }
+
+  intptr_t get_field_index(PyObject *key, Py_ssize_t pos)
+  {
+    if (pos < static_cast<Py_ssize_t>(m_cached_keys.size()) && m_cached_keys[pos] == key) {
+      return m_cached_fields[pos];
+    }
+
+    if (m_field_indices == NULL) {
+      const dynd::ndt::struct_type *st = m_dst_tp.extended<dynd::ndt::struct_type>();
+      pydynd::pyobject_ownref field_indices(PyDict_New());
+      for (intptr_t i = 0; i < st->get_field_count(); ++i) {
+        const dynd::string &name = st->get_field_name(i);
+        pydynd::pyobject_ownref name_obj(pydynd::pystring_from_string(std::string(name.begin(), name.end())));
+        pydynd::pyobject_ownref index_obj(PyLong_FromSsize_t(i));
+        if (PyDict_SetItem(field_indices.get(), name_obj.get(), index_obj.get()) < 0) {
+          throw std::exception();
+        }
+      }
+      m_field_indices = field_indices.release();
+    }
+
+    PyObject *index_obj = PyDict_GetItem(m_field_indices, key);
+    if (index_obj == NULL) {
+      // TODO: Add an error policy of whether to throw an error
+      //       or not. For now, just raise an error
+      std::stringstream ss;
+      ss << "Input python dict has key ";
+      dynd::print_escaped_utf8_string(ss, pydynd::pystring_as_string(key));
+      ss << ", but no such field is in destination dynd type " << m_dst_tp;
+      throw dynd::broadcast_error(ss.str());
+    }
+    intptr_t i = PyLong_AsSsize_t(index_obj);
+
+    if (pos >= static_cast<Py_ssize_t>(m_cached_keys.size())) {
+      m_cached_keys.resize(pos + 1, NULL);
+      m_cached_fields.resize(pos + 1, -1);
+    }
+    Py_INCREF(key);
+    Py_XDECREF(m_cached_keys[pos]);
+    m_cached_keys[pos] = key;
+    m_cached_fields[pos] = i;
+    return i;
+  }
+
+  /**
+   * Assigns `count` dicts, which are `src_stride` apart, to the structs
+   * `dst_stride` apart.
+   */
+  void assign_dicts(char *dst, intptr_t dst_stride, char *src, intptr_t src_stride, intptr_t count)
+  {
+    intptr_t field_count = m_dst_tp.extended<dynd::ndt::tuple_type>()->get_field_count();
+    const uintptr_t *field_offsets = reinterpret_cast<const uintptr_t *>(m_dst_arrmeta);
+    m_values.resize(field_count * block_size);
+
+    intptr_t value_stride = sizeof(PyObject *);
+    while (count > 0) {
+      intptr_t block_count = count < block_size ? count : block_size;
+      for (intptr_t j = 0; j < block_count; ++j, src += src_stride) {
+        PyObject *src_obj = *reinterpret_cast<PyObject *const *>(src);
+        PyObject *dict_key = NULL, *dict_value = NULL;
+        Py_ssize_t dict_pos = 0, key_pos = 0;
+        if (PyDict_Size(src_obj) != field_count) {
+          // Keep track of which fields we've seen, to report a missing one
+          for (intptr_t i = 0; i < field_count; ++i) {
+            m_values[i * block_size + j] = NULL;
+          }
+        }
+        while (PyDict_Next(src_obj, &dict_pos, &dict_key, &dict_value)) {
+          m_values[get_field_index(dict_key, key_pos++) * block_size + j] = dict_value;
+        }
+        if (key_pos != field_count) {
+          for (intptr_t i = 0; i < field_count; ++i) {
+            if (m_values[i * block_size + j] == NULL) {
+              std::stringstream ss;
+              ss << "python dict does not contain the field ";
+              dynd::print_escaped_utf8_string(ss, m_dst_tp.extended<dynd::ndt::struct_type>()->get_field_name(i));
+              ss << " as required by the data type " << m_dst_tp;
+              throw dynd::broadcast_error(ss.str());
+            }
+          }
+        }
+      }
+
+      for (intptr_t i = 0; i < field_count; ++i) {
+        nd::kernel_prefix *copy_el = get_child(m_copy_el_offsets[i]);
+        dynd::kernel_strided_t copy_el_fn = copy_el->get_function<dynd::kernel_strided_t>();
+        char *el_src = reinterpret_cast<char *>(&m_values[i * block_size]);
+        copy_el_fn(copy_el, dst + field_offsets[i], dst_stride, &el_src, &value_stride, block_count);
+      }
+      if (PyErr_Occurred()) {
+        throw std::exception();
+      }
+      dst += block_count * dst_stride;
+      count -= block_count;
+    }
+  }
+
+  void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count)
+  {
+    char *src0 = src[0];
+    intptr_t src0_stride = src_stride[0];
+    size_t i = 0;
+    while (i < count) {
+      // Assign each run of dicts together, and anything else one by one
+      size_t run_end = i;
+      while (run_end < count && PyDict_Check(*reinterpret_cast<PyObject *const *>(src0 + run_end * src0_stride))) {
+        ++run_end;
+      }
+      if (run_end > i) {
+        assign_dicts(dst + i * dst_stride, dst_stride, src0 + i * src0_stride, src0_stride, run_end - i);
+        i = run_end;
+      }
+      else {
+        char *child_src = src0 + i * src0_stride;
+        single(dst + i * dst_stride, &child_src);
+        ++i;
+      }
+    }
   }
 
   void single(char *dst, char *const *src)
@@ -611,44 +943,7 @@ struct assign_from_pyobject_kernel<dynd::ndt::struct_type>
     const uintptr_t *field_offsets = reinterpret_cast<const uintptr_t *>(m_dst_arrmeta);
 
     if (PyDict_Check(src_obj)) {
-      // Keep track of which fields we've seen
-      dynd::shortvector<bool> populated_fields(field_count);
-      memset(populated_fields.get(), 0, sizeof(bool) * field_count);
-
-      PyObject *dict_key = NULL, *dict_value = NULL;
-      Py_ssize_t dict_pos = 0;
-
-      while (PyDict_Next(src_obj, &dict_pos, &dict_key, &dict_value)) {
-        std::string name = pydynd::pystring_as_string(dict_key);
-        intptr_t i = m_dst_tp.extended<dynd::ndt::struct_type>()->get_field_index(name);
-        // TODO: Add an error policy of whether to throw an error
-        //       or not. For now, just raise an error
-        if (i >= 0) {
-          nd::kernel_prefix *copy_el = get_child(m_copy_el_offsets[i]);
-          dynd::kernel_single_t copy_el_fn = copy_el->get_function<dynd::kernel_single_t>();
-          char *el_dst = dst + field_offsets[i];
-          char *el_src = reinterpret_cast<char *>(&dict_value);
-          copy_el_fn(copy_el, el_dst, &el_src);
-          populated_fields[i] = true;
-        }
-        else {
-          std::stringstream ss;
-          ss << "Input python dict has key ";
-          dynd::print_escaped_utf8_string(ss, name);
-          ss << ", but no such field is in destination dynd type " << m_dst_tp;
-          throw dynd::broadcast_error(ss.str());
-        }
-      }
-
-      for (intptr_t i = 0; i < field_count; ++i) {
-        if (!populated_fields[i]) {
-          std::stringstream ss;
-          ss << "python dict does not contain the field ";
-          dynd::print_escaped_utf8_string(ss, m_dst_tp.extended<dynd::ndt::struct_type>()->get_field_name(i));
-          ss << " as required by the data type " << m_dst_tp;
-          throw dynd::broadcast_error(ss.str());
-        }
-      }
+      assign_dicts(dst, 0, src[0], 0, 1);
     }
     else {
       // Get the input as an array of PyObject *
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <cstring>
+#include <vector>
+
 #include <dynd/kernels/base_kernel.hpp>
 
+#include "numpy_interop_defines.hpp"
+#include "utility_functions.hpp"
+
 namespace pydynd {
 namespace nd {
   namespace functional {
@@ -11,6 +17,13 @@ namespace nd {
       PyUFuncGenericFunction funcptr;
       void *ufunc_data;
       intptr_t param_count;
+      // The element sizes of the loop's inputs, followed by its output
+      intptr_t item_size[NPY_MAXARGS];
+
+      scalar_ufunc_data() : ufunc(NULL), funcptr(NULL), ufunc_data(NULL), param_count(0)
+      {
+        memset(item_size, 0, sizeof(item_size));
+      }
 
       ~scalar_ufunc_data()
       {
@@ -22,71 +35,165 @@ namespace nd {
       }
     };
 
+    /**
+     * Copies `count` elements of `item_size` bytes between strided
+     * buffers, with fixed size copies for the common element sizes.
+     */
+    inline void copy_ufunc_elements(char *dst, intptr_t dst_stride, const char *src, intptr_t src_stride,
+                                    intptr_t count, intptr_t item_size)
+    {
+      switch (item_size) {
+      case 1:
+        for (intptr_t i = 0; i < count; ++i, dst += dst_stride, src += src_stride) {
+          *dst = *src;
+        }
+        break;
+      case 2:
+        for (intptr_t i = 0; i < count; ++i, dst += dst_stride, src += src_stride) {
+          memcpy(dst, src, 2);
+        }
+        break;
+      case 4:
+        for (intptr_t i = 0; i < count; ++i, dst += dst_stride, src += src_stride) {
+          memcpy(dst, src, 4);
+        }
+        break;
+      case 8:
+        for (intptr_t i = 0; i < count; ++i, dst += dst_stride, src += src_stride) {
+          memcpy(dst, src, 8);
+        }
+        break;
+      case 16:
+        for (intptr_t i = 0; i < count; ++i, dst += dst_stride, src += src_stride) {
+          memcpy(dst, src, 16);
+        }
+        break;
+      default:
+        for (intptr_t i = 0; i < count; ++i, dst += dst_stride, src += src_stride) {
+          memcpy(dst, src, item_size);
+        }
+        break;
+      }
+    }
+
     template <bool gil>
     struct scalar_ufunc_ck;
 
+    /**
+     * Calls a NumPy ufunc loop which doesn't need the GIL.
+     *
+     * NumPy's loops only use SIMD instructions when every operand is
+     * contiguous or, for inputs, a broadcast scalar with a stride of 0.
+     * Strided calls whose operands are like that go to the loop in one
+     * call. Otherwise the strided operands are gathered into contiguous
+     * buffers, and the loop is run over blocks of `buffer_size` elements,
+     * with the results scattered back to the destination.
+     *
+     * A single() call has to finish writing its element before it
+     * returns, so it can't be buffered, and goes to the loop on its own.
+     */
     template <>
     struct scalar_ufunc_ck<false>
-        : dynd::nd::base_strided_kernel<scalar_ufunc_ck<false>, 1> {
+        : dynd::nd::base_strided_kernel<scalar_ufunc_ck<false>> {
       typedef scalar_ufunc_ck self_type;
 
+      // The number of elements in each block of a buffered call
+      static const intptr_t buffer_size = 512;
+      // Shorter strided calls aren't worth buffering
+      static const intptr_t min_buffered_count = 16;
+
       const scalar_ufunc_data *data;
 
       scalar_ufunc_ck(const scalar_ufunc_data *data) : data(data) {}
 
       void single(char *dst, char *const *src)
       {
+        // All of the strides are 0 for a loop over one element
+        static const intptr_t strides[NPY_MAXARGS] = {0};
+        intptr_t param_count = data->param_count;
         char *args[NPY_MAXARGS];
-        // Set up the args array the way the numpy ufunc wants it
-        memcpy(&args[0], &src[0], data->param_count * sizeof(void *));
-        args[data->param_count] = dst;
-        // Call the ufunc loop with a dim size of 1
+        for (intptr_t i = 0; i < param_count; ++i) {
+          args[i] = src[i];
+        }
+        args[param_count] = dst;
         intptr_t dimsize = 1;
-        intptr_t strides[NPY_MAXARGS];
-        memset(strides, 0, (data->param_count + 1) * sizeof(intptr_t));
-        data->funcptr(args, &dimsize, strides, data->ufunc_data);
+        data->funcptr(args, &dimsize, const_cast<intptr_t *>(strides), data->ufunc_data);
       }
 
       void strided(char *dst, intptr_t dst_stride, char *const *src,
                    const intptr_t *src_stride, size_t count)
       {
+        intptr_t param_count = data->param_count;
+        const intptr_t *item_size = data->item_size;
         char *args[NPY_MAXARGS];
-        // Set up the args array the way the numpy ufunc wants it
-        memcpy(&args[0], &src[0], data->param_count * sizeof(void *));
-        args[data->param_count] = dst;
-        // Call the ufunc loop with a dim size of 1
         intptr_t strides[NPY_MAXARGS];
-        memcpy(&strides[0], &src_stride[0],
-               data->param_count * sizeof(intptr_t));
-        strides[data->param_count] = dst_stride;
-        data->funcptr(args, reinterpret_cast<intptr_t *>(&count), strides,
-                      data->ufunc_data);
-      }
+        // Which operands have to go through a buffer
+        bool buffered[NPY_MAXARGS];
+        bool any_buffered = dst_stride != item_size[param_count];
+        buffered[param_count] = any_buffered;
+        for (intptr_t i = 0; i < param_count; ++i) {
+          buffered[i] = src_stride[i] != 0 && src_stride[i] != item_size[i];
+          any_buffered = any_buffered || buffered[i];
+        }
 
-      static void
-      instantiate(char *static_data, char *DYND_UNUSED(data),
-                  kernel_builder *ckb, intptr_t ckb_offset,
-                  const dynd::ndt::type &dst_tp,
-                  const char *DYND_UNUSED(dst_arrmeta),
-                  intptr_t DYND_UNUSED(nsrc), const dynd::ndt::type *src_tp,
-                  const char *const *DYND_UNUSED(src_arrmeta),
-                  dynd::kernel_request_t kernreq,
-                  const dynd::eval::eval_context *DYND_UNUSED(ectx),
-                  intptr_t nkwd, const dynd::nd::array *kwds,
-                  const std::map<std::string, dynd::ndt::type> &tp_vars)
-      {
-        // Acquire the GIL for creating the ckernel
-        PyGILState_RAII pgs;
-        self_type::make(
-            ckb, kernreq,
-            reinterpret_cast<std::shared_ptr<scalar_ufunc_data> *>(static_data)
-                ->get());
+        if (!any_buffered || static_cast<intptr_t>(count) < min_buffered_count) {
+          memcpy(&args[0], &src[0], param_count * sizeof(void *));
+          args[param_count] = dst;
+          memcpy(&strides[0], &src_stride[0], param_count * sizeof(intptr_t));
+          strides[param_count] = dst_stride;
+          data->funcptr(args, reinterpret_cast<intptr_t *>(&count), strides, data->ufunc_data);
+          return;
+        }
+
+        // One contiguous block for each buffered operand
+        std::vector<char *> buffers(param_count + 1);
+        intptr_t buffer_bytes = 0;
+        for (intptr_t i = 0; i <= param_count; ++i) {
+          if (buffered[i]) {
+            buffer_bytes += buffer_size * item_size[i];
+          }
+        }
+        std::vector<char> storage(buffer_bytes);
+        char *next_buffer = storage.data();
+        for (intptr_t i = 0; i <= param_count; ++i) {
+          if (buffered[i]) {
+            buffers[i] = next_buffer;
+            next_buffer += buffer_size * item_size[i];
+            strides[i] = item_size[i];
+          } else {
+            strides[i] = (i < param_count) ? src_stride[i] : dst_stride;
+          }
+        }
+
+        for (intptr_t begin = 0; begin < static_cast<intptr_t>(count); begin += buffer_size) {
+          intptr_t n = static_cast<intptr_t>(count) - begin;
+          if (n > buffer_size) {
+            n = buffer_size;
+          }
+          for (intptr_t i = 0; i < param_count; ++i) {
+            if (buffered[i]) {
+              copy_ufunc_elements(buffers[i], item_size[i], src[i] + begin * src_stride[i], src_stride[i], n,
+                                  item_size[i]);
+              args[i] = buffers[i];
+            } else {
+              args[i] = src[i] + begin * src_stride[i];
+            }
+          }
+          args[param_count] = buffered[param_count] ? buffers[param_count] : dst + begin * dst_stride;
+
+          data->funcptr(args, &n, strides, data->ufunc_data);
+
+          if (buffered[param_count]) {
+            copy_ufunc_elements(dst + begin * dst_stride, dst_stride, buffers[param_count],
+                                item_size[param_count], n, item_size[param_count]);
+          }
+        }
       }
     };
 
     template <>
     struct scalar_ufunc_ck<true>
-        : dynd::nd::base_strided_kernel<scalar_ufunc_ck<true>, 1> {
+        : dynd::nd::base_strided_kernel<scalar_ufunc_ck<true>> {
       typedef scalar_ufunc_ck self_type;
 
       const scalar_ufunc_data *data;
@@ -127,26 +234,6 @@ namespace nd {
                         data->ufunc_data);
         }
       }
-
-      static intptr_t
-      instantiate(char *static_data, char *DYND_UNUSED(data), void *ckb,
-                  intptr_t ckb_offset, const dynd::ndt::type &dst_tp,
-                  const char *DYND_UNUSED(dst_arrmeta),
-                  intptr_t DYND_UNUSED(nsrc), const dynd::ndt::type *src_tp,
-                  const char *const *DYND_UNUSED(src_arrmeta),
-                  dynd::kernel_request_t kernreq,
-                  const dynd::eval::eval_context *DYND_UNUSED(ectx),
-                  intptr_t nkwd, const dynd::nd::array *kwds,
-                  const std::map<std::string, dynd::ndt::type> &tp_vars)
-      {
-        // Acquire the GIL for creating the ckernel
-        PyGILState_RAII pgs;
-        self_type::make(
-            ckb, kernreq, ckb_offset,
-            reinterpret_cast<std::shared_ptr<scalar_ufunc_data> *>(static_data)
-                ->get());
-        return ckb_offset;
-      }
     };
 
   } // namespace pydynd::nd::functional
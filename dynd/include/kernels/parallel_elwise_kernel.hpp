@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Python.h>
+
+#include <vector>
+
+#include <dynd/kernels/base_kernel.hpp>
+
+#include "thread_pool.hpp"
+
+namespace pydynd {
+namespace nd {
+  namespace functional {
+
+    /**
+     * Runs the child kernel over the outermost dimension, split into
+     * chunks of `grain` elements which are processed on the thread pool.
+     * Each chunk is a single strided() call of the child, so the child
+     * must be safe to call from several threads at once, which holds for
+     * the stateless elementwise kernels dynd builds.
+     */
+    struct parallel_elwise_kernel : dynd::nd::base_strided_kernel<parallel_elwise_kernel> {
+      intptr_t m_size;
+      intptr_t m_dst_stride;
+      std::vector<intptr_t> m_src_stride;
+      intptr_t m_nthreads;
+      intptr_t m_grain;
+
+      parallel_elwise_kernel(intptr_t size, intptr_t dst_stride, size_t nsrc, const intptr_t *src_stride,
+                             intptr_t nthreads, intptr_t grain)
+          : m_size(size), m_dst_stride(dst_stride), m_src_stride(src_stride, src_stride + nsrc), m_nthreads(nthreads),
+            m_grain(grain)
+      {
+      }
+
+      ~parallel_elwise_kernel() { get_child()->destroy(); }
+
+      void single(char *dst, char *const *src)
+      {
+        dynd::nd::kernel_prefix *child = get_child();
+        dynd::kernel_strided_t child_fn = child->get_function<dynd::kernel_strided_t>();
+        size_t nsrc = m_src_stride.size();
+
+        intptr_t nthreads = m_nthreads;
+#if PY_VERSION_HEX >= 0x03040000
+        // A child which calls back into Python would deadlock waiting for
+        // the GIL on a worker, so stay on this thread if we hold it
+        if (PyGILState_Check()) {
+          nthreads = 1;
+        }
+#endif
+        intptr_t grain = m_grain;
+        if (grain <= 0) {
+          // Give each thread a few chunks, so the stragglers can be balanced
+          grain = (m_size + 4 * nthreads - 1) / (4 * nthreads);
+        }
+
+        get_thread_pool().parallel_for(m_size, grain, nthreads, [&](intptr_t begin, intptr_t end) {
+          std::vector<char *> child_src(nsrc);
+          for (size_t i = 0; i < nsrc; ++i) {
+            child_src[i] = src[i] + begin * m_src_stride[i];
+          }
+          child_fn(child, dst + begin * m_dst_stride, m_dst_stride, child_src.data(), m_src_stride.data(),
+                   end - begin);
+        });
+      }
+    };
+
+  } // namespace pydynd::nd::functional
+} // namespace pydynd::nd
+} // namespace pydynd
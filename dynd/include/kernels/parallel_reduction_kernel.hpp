@@ -0,0 +1,121 @@
+#pragma once
+
+#include <Python.h>
+
+#include <cstring>
+#include <vector>
+
+#include <dynd/array.hpp>
+#include <dynd/callable.hpp>
+#include <dynd/kernels/base_kernel.hpp>
+
+#include "thread_pool.hpp"
+
+namespace pydynd {
+namespace nd {
+  namespace functional {
+
+    /**
+     * Reduces an array of fixed dimensions to a scalar by splitting its
+     * outermost dimension into blocks, reducing each block with the child
+     * callable on the thread pool, and reducing the array of per-block
+     * results with the child again. Every block starts from the child's
+     * identity, so the child must be associative.
+     *
+     * Summing blocks and then the block sums also keeps the rounding error
+     * of a floating point sum down to that of the largest block.
+     *
+     * The child kernel built for the whole array is kept for calls which
+     * have to stay on this thread.
+     */
+    struct parallel_reduction_kernel : dynd::nd::base_strided_kernel<parallel_reduction_kernel> {
+      // The largest number of elements reduced by one block
+      static const intptr_t max_block_size = 1 << 20;
+
+      dynd::nd::callable m_child;
+      dynd::ndt::type m_src_dtype;
+      dynd::ndt::type m_dst_tp;
+      std::vector<intptr_t> m_shape;
+      std::vector<intptr_t> m_strides;
+      intptr_t m_nthreads;
+      intptr_t m_grain;
+
+      parallel_reduction_kernel(const dynd::nd::callable &child, const dynd::ndt::type &src_dtype,
+                                const dynd::ndt::type &dst_tp, intptr_t ndim, const intptr_t *shape,
+                                const intptr_t *strides, intptr_t nthreads, intptr_t grain)
+          : m_child(child), m_src_dtype(src_dtype), m_dst_tp(dst_tp), m_shape(shape, shape + ndim),
+            m_strides(strides, strides + ndim), m_nthreads(nthreads), m_grain(grain)
+      {
+      }
+
+      ~parallel_reduction_kernel() { get_child()->destroy(); }
+
+      intptr_t get_block_rows(intptr_t nthreads) const
+      {
+        if (m_grain > 0) {
+          return m_grain;
+        }
+
+        intptr_t size = m_shape[0];
+        intptr_t row_size = 1;
+        for (size_t i = 1; i < m_shape.size(); ++i) {
+          row_size *= m_shape[i];
+        }
+        // Give each thread a few blocks, so the stragglers can be balanced
+        intptr_t rows = (size + 4 * nthreads - 1) / (4 * nthreads);
+        intptr_t max_rows = row_size > 0 ? max_block_size / row_size : size;
+        if (rows > max_rows) {
+          rows = max_rows;
+        }
+        return rows > 0 ? rows : 1;
+      }
+
+      dynd::nd::array reduce_rows(char *src, intptr_t begin, intptr_t end)
+      {
+        std::vector<intptr_t> shape(m_shape);
+        shape[0] = end - begin;
+        dynd::nd::array block = dynd::nd::make_strided_array_from_data(
+            m_src_dtype, static_cast<intptr_t>(shape.size()), shape.data(), m_strides.data(),
+            dynd::nd::read_access_flag, src + begin * m_strides[0], dynd::nd::memory_block(), NULL);
+        return m_child(block);
+      }
+
+      void single(char *dst, char *const *src)
+      {
+        intptr_t nthreads = m_nthreads;
+#if PY_VERSION_HEX >= 0x03040000
+        // A child which calls back into Python would deadlock waiting for
+        // the GIL on a worker, so stay on this thread if we hold it
+        if (PyGILState_Check()) {
+          nthreads = 1;
+        }
+#endif
+        intptr_t size = m_shape[0];
+        intptr_t block_rows = get_block_rows(nthreads);
+        intptr_t nblocks = (size + block_rows - 1) / block_rows;
+        if (nthreads <= 1 || nblocks <= 1) {
+          get_child()->single(dst, src);
+          return;
+        }
+
+        intptr_t dst_size = static_cast<intptr_t>(m_dst_tp.get_data_size());
+        std::vector<char> partials(nblocks * dst_size);
+        get_thread_pool().parallel_for(nblocks, 1, nthreads, [&](intptr_t begin, intptr_t end) {
+          for (intptr_t k = begin; k < end; ++k) {
+            intptr_t row_end = (k + 1) * block_rows < size ? (k + 1) * block_rows : size;
+            dynd::nd::array partial = reduce_rows(src[0], k * block_rows, row_end);
+            memcpy(partials.data() + k * dst_size, partial.cdata(), dst_size);
+          }
+        });
+
+        dynd::nd::array combined = dynd::nd::make_strided_array_from_data(
+            m_dst_tp, 1, &nblocks, &dst_size, dynd::nd::read_access_flag, partials.data(), dynd::nd::memory_block(),
+            NULL);
+        dynd::nd::array result = m_child(combined);
+        memcpy(dst, result.cdata(), dst_size);
+      }
+    };
+
+  } // namespace pydynd::nd::functional
+} // namespace pydynd::nd
+} // namespace pydynd
@@ -0,0 +1,39 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+// Arrays backed by memory-mapped files. A file starts with a small header
+// recording the array's type, followed by its C-contiguous data.
+//
+
+#pragma once
+
+#include <Python.h>
+
+#include <string>
+
+#include <dynd/array.hpp>
+
+#include "visibility.hpp"
+
+namespace pydynd {
+
+/**
+ * Maps the file at `path` into memory, returning an array which views its
+ * data. The pages are read in by the OS on first access, and the mapping
+ * is unmapped when the array's memory is released.
+ *
+ * The modes are:
+ *  - "r": an existing file, read only.
+ *  - "r+": an existing file, read and write, with writes going to the file.
+ *  - "c": an existing file, copy on write, with writes kept in memory.
+ *  - "w+": a new file of type `tp`, replacing any existing one, zero filled.
+ *
+ * The type must have fixed dimensions and a dtype without references to
+ * other memory, such as a number or a fixed-size string. For existing
+ * files `tp` may be uninitialized, in which case the type is read from
+ * the header, otherwise it must match the header.
+ */
+PYDYND_API dynd::nd::array array_memmap(const std::string &path, const dynd::ndt::type &tp, const std::string &mode);
+
+} // namespace pydynd
@@ -0,0 +1,254 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+namespace pydynd {
+
+/**
+ * A pool of worker threads for running the chunks of a parallel loop.
+ *
+ * Each call to parallel_for splits [0, size) into chunks of `grain`
+ * iterations, and the calling thread plus up to nthreads - 1 workers
+ * claim chunks from a shared counter until none are left. Threads which
+ * finish early keep claiming chunks, so uneven chunks balance out.
+ *
+ * The workers are started lazily and live until the module is unloaded.
+ * Only one loop runs on the pool at a time. A loop started from inside
+ * a chunk, or while another thread is using the pool, runs serially on
+ * the calling thread instead of waiting.
+ *
+ * A child process made by fork() has none of the workers, so a pool
+ * belongs to the process which created it, and get_thread_pool() makes
+ * a new one in the child.
+ */
+class thread_pool {
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_start_cv, m_done_cv;
+  // Guards the whole of a parallel_for, so loops don't interleave
+  std::mutex m_run_mutex;
+  bool m_stop;
+  // Incremented for each loop, so workers know when there is new work
+  size_t m_generation;
+  // Number of workers asked to join the current loop, and still in it
+  size_t m_nrequested, m_nactive;
+
+  // The current loop
+  const std::function<void(intptr_t, intptr_t)> *m_func;
+  intptr_t m_size, m_grain;
+  std::atomic<intptr_t> m_next;
+  std::exception_ptr m_error;
+
+  // Totals over the pool's life, of loops which used more than one
+  // thread and of the chunks they ran
+  std::atomic<int64_t> m_nloops, m_nchunks;
+
+#if !defined(_WIN32)
+  // The process the workers were started in
+  pid_t m_pid;
+#endif
+
+  thread_pool(const thread_pool &);
+  thread_pool &operator=(const thread_pool &);
+
+  static bool &in_parallel_region()
+  {
+    static thread_local bool value = false;
+    return value;
+  }
+
+  void run_chunks()
+  {
+    for (;;) {
+      intptr_t begin = m_next.fetch_add(m_grain);
+      if (begin >= m_size) {
+        return;
+      }
+      ++m_nchunks;
+      try {
+        (*m_func)(begin, std::min(begin + m_grain, m_size));
+      }
+      catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_error) {
+          m_error = std::current_exception();
+        }
+        // Stop handing out chunks
+        m_next = m_size;
+      }
+    }
+  }
+
+  void worker_main(size_t index)
+  {
+    in_parallel_region() = true;
+    size_t seen_generation = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_start_cv.wait(lock, [&] { return m_stop || (m_generation != seen_generation && index < m_nrequested); });
+        if (m_stop) {
+          return;
+        }
+        seen_generation = m_generation;
+      }
+
+      run_chunks();
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (--m_nactive == 0) {
+        m_done_cv.notify_one();
+      }
+    }
+  }
+
+public:
+  thread_pool()
+      : m_stop(false), m_generation(0), m_nrequested(0), m_nactive(0), m_func(NULL), m_size(0), m_grain(1),
+        m_nloops(0), m_nchunks(0)
+  {
+#if !defined(_WIN32)
+    m_pid = getpid();
+#endif
+  }
+
+  ~thread_pool()
+  {
+    if (is_forked()) {
+      // The workers only exist in the parent, so there is nothing to join,
+      // and destroying their handles would terminate the process
+      new std::vector<std::thread>(std::move(m_workers));
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_start_cv.notify_all();
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+      m_workers[i].join();
+    }
+  }
+
+  /**
+   * Whether this is a child process forked after the pool was created.
+   */
+  bool is_forked() const
+  {
+#if !defined(_WIN32)
+    return getpid() != m_pid;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * The number of loops which ran on more than one thread.
+   */
+  int64_t get_nloops() const { return m_nloops; }
+
+  /**
+   * The number of chunks run by those loops.
+   */
+  int64_t get_nchunks() const { return m_nchunks; }
+
+  /**
+   * The number of threads used when a caller asks for "all of them".
+   */
+  static intptr_t default_nthreads()
+  {
+    unsigned int n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : static_cast<intptr_t>(n);
+  }
+
+  /**
+   * Calls func(begin, end) over chunks covering [0, size), using up to
+   * nthreads threads including the calling one. Exceptions thrown by
+   * func are rethrown on the calling thread once all chunks are done.
+   */
+  void parallel_for(intptr_t size, intptr_t grain, intptr_t nthreads,
+                    const std::function<void(intptr_t, intptr_t)> &func)
+  {
+    grain = std::max<intptr_t>(grain, 1);
+    nthreads = std::min(nthreads, (size + grain - 1) / grain);
+    std::unique_lock<std::mutex> run_lock(m_run_mutex, std::defer_lock);
+    if (nthreads <= 1 || in_parallel_region() || !run_lock.try_lock()) {
+      func(0, size);
+      return;
+    }
+
+    ++m_nloops;
+    size_t nworkers = static_cast<size_t>(nthreads - 1);
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      while (m_workers.size() < nworkers) {
+        m_workers.push_back(std::thread(&thread_pool::worker_main, this, m_workers.size()));
+      }
+      m_func = &func;
+      m_size = size;
+      m_grain = grain;
+      m_next = 0;
+      m_error = std::exception_ptr();
+      m_nrequested = nworkers;
+      m_nactive = nworkers;
+      ++m_generation;
+    }
+    m_start_cv.notify_all();
+
+    in_parallel_region() = true;
+    run_chunks();
+    in_parallel_region() = false;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_cv.wait(lock, [&] { return m_nactive == 0; });
+    m_func = NULL;
+    if (m_error) {
+      std::exception_ptr error = m_error;
+      m_error = std::exception_ptr();
+      lock.unlock();
+      std::rethrow_exception(error);
+    }
+  }
+};
+
+/**
+ * The pool shared by all parallel kernels in this module.
+ */
+inline thread_pool &get_thread_pool()
+{
+  static thread_pool pool;
+  static std::atomic<thread_pool *> current(&pool);
+
+  thread_pool *p = current.load();
+  if (p->is_forked()) {
+    // The old pool may have been mid-loop in another thread of the parent,
+    // so its locks can't be trusted either, and it is leaked instead
+    thread_pool *fresh = new thread_pool;
+    if (current.compare_exchange_strong(p, fresh)) {
+      p = fresh;
+    }
+    else {
+      delete fresh;
+    }
+  }
+  return *p;
+}
+
+} // namespace pydynd
@@ -39,3 +39,13 @@ namespace ndt {
 
 } // namespace dynd::ndt
 } // namespace dynd
+
+namespace pydynd {
+
+/**
+ * Returns true if the type holds PyObject pointers anywhere in its data,
+ * in which case the kernels that process it need to hold the GIL.
+ */
+PYDYND_API bool type_contains_pyobject(const dynd::ndt::type &tp);
+
+} // namespace pydynd
@@ -0,0 +1,31 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+// Wrapping the inner loops of NumPy ufuncs as dynd callables.
+//
+
+#pragma once
+
+#include <Python.h>
+
+#include <vector>
+
+#include <dynd/callable.hpp>
+
+#include "visibility.hpp"
+
+namespace pydynd {
+
+/**
+ * Returns a callable for each inner loop of a NumPy ufunc with a single
+ * output, in the order of the ufunc's `types` table. Loops whose types
+ * have no builtin dynd equivalent, like object or datetime loops, are
+ * skipped, as are loops with the same dynd signature as an earlier one
+ * (such as the long and long long loops where both are 64 bits).
+ *
+ * \param ufunc  A numpy.ufunc object.
+ */
+PYDYND_API std::vector<dynd::nd::callable> ufunc_loop_callables(PyObject *ufunc);
+
+} // namespace pydynd
@@ -114,6 +114,23 @@ public:
   inline ~PyGILState_RAII() { PyGILState_Release(m_gstate); }
 };
 
+/**
+ * Releases the GIL for the lifetime of the object. The GIL is
+ * reacquired on destruction, including when an exception unwinds
+ * the stack, so the exception can be translated to Python.
+ */
+class PyAllowThreads_RAII {
+  PyThreadState *m_state;
+
+  PyAllowThreads_RAII(const PyAllowThreads_RAII &);
+  PyAllowThreads_RAII &operator=(const PyAllowThreads_RAII &);
+
+public:
+  inline PyAllowThreads_RAII() { m_state = PyEval_SaveThread(); }
+
+  inline ~PyAllowThreads_RAII() { PyEval_RestoreThread(m_state); }
+};
+
 /**
  * Function which casts the parameter to
  * a PyObject pointer and calls Py_XDECREF on it.
@@ -9,7 +9,9 @@ from dynd.config import *
 
 from .array import array, asarray, type_of, dshape_of, as_py, view, \
     ones, zeros, empty, is_c_contiguous, is_f_contiguous, old_range, \
-    parse_json, squeeze, dtype_of, old_linspace, fields, ndim_of
+    parse_json, squeeze, dtype_of, old_linspace, fields, ndim_of, \
+    string_offsets, from_string_offsets, from_dlpack, parse_json_stream, \
+    categorical_codes, from_categorical_codes, memmap
 from .callable import callable
 
 inf = float('inf')
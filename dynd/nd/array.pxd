@@ -15,5 +15,7 @@ cdef api _array dynd_nd_array_to_cpp(array) nogil except *
 cdef api _array *dynd_nd_array_to_ptr(array) nogil except *
 cdef api array dynd_nd_array_from_cpp(_array)
 
-cdef _callable _functional_apply(_type t, object o) except *
+cdef _callable _functional_apply(_type t, object o, bint batch=*) except *
+cdef list _functional_ufunc_loops(object ufunc)
+cdef bint _type_contains_pyobject(_type tp) nogil
 cdef void _registry_assign_init() except *
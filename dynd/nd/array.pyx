@@ -11,7 +11,9 @@ from libcpp cimport bool as cpp_bool
 from libcpp.complex cimport complex as cpp_complex
 from cython.operator import dereference
 from libcpp.vector cimport vector
+from libcpp.pair cimport pair
 import numpy as _np
+import sys
 
 from ..cpp.array cimport (groupby as dynd_groupby, empty as cpp_empty,
                           dtyped_zeros, dtyped_ones, dtyped_empty, array_and)
@@ -22,7 +24,7 @@ from ..cpp.registry cimport registered
 from ..cpp.types.datashape_formatter cimport format_datashape as dynd_format_datashape
 from ..cpp.types.type_id cimport *
 from ..cpp.view cimport view as _view
-from ..pyobject_type cimport pyobject_id
+from ..pyobject_type cimport pyobject_id, type_contains_pyobject
 
 from ..config cimport translate_exception
 from ..ndt.type cimport (type as _py_type, dynd_ndt_type_to_cpp, as_cpp_type,
@@ -57,12 +59,48 @@ cdef extern from 'array_functions.hpp' namespace 'pydynd':
     void dynd_parse_json_array(_array&, _array&, object) except +translate_exception
 
     _array nd_fields(_array&, object) except +translate_exception
+    _array array_as_columnar(_array&) except +translate_exception
 
     int array_getbuffer_pep3118(object ndo, Py_buffer *buffer, int flags) except -1
     int array_releasebuffer_pep3118(object ndo, Py_buffer *buffer) except -1
 
 cdef extern from "array_from_py.hpp" namespace "pydynd":
     void init_array_from_py() except *
+    _array array_from_numeric_pylist(object) except +translate_exception
+    _array array_from_pep3118_buffer(object, unsigned int, bint) except +translate_exception
+
+cdef extern from "arrow_interop.hpp" namespace "pydynd":
+    pair[_array, _array] array_as_string_offsets(_array&, bint) except +translate_exception
+    _array array_from_string_offsets(_array&, _array&) except +translate_exception
+    object array_as_arrow_c_array(_array&) except +translate_exception
+    _array array_from_arrow_c_array(object, object) except +translate_exception
+
+cdef extern from "array_as_py.hpp" namespace "pydynd":
+    object array_as_numeric_pylist(_array&, bint) except +translate_exception
+
+cdef extern from "json_lines.hpp" namespace "pydynd":
+    intptr_t parse_json_lines(_array&, intptr_t, const char *, const char *, bint,
+                              intptr_t *) except +translate_exception
+    _array parse_json_lines_parallel(_type&, const char *, const char *,
+                                     intptr_t) except +translate_exception
+    void parse_json_lines_parallel(_array&, const char *, const char *,
+                                   intptr_t) except +translate_exception
+
+cdef extern from "fancy_indexing.hpp" namespace "pydynd":
+    bint array_is_index_array(_array&)
+    _array array_take(_array&, _array&) except +translate_exception
+    void array_put(_array&, _array&, _array&) except +translate_exception
+
+cdef extern from "categorical_interop.hpp" namespace "pydynd":
+    pair[_array, _array] array_as_categorical_codes(_array&) except +translate_exception
+    _array array_from_categorical_codes(_array&, _array&) except +translate_exception
+
+cdef extern from "memmap.hpp" namespace "pydynd":
+    _array array_memmap(string, _type&, string) except +translate_exception
+
+cdef extern from "dlpack_interop.hpp" namespace "pydynd":
+    object array_as_dlpack(_array&) except +translate_exception
+    _array array_from_dlpack(object) except +translate_exception
 
 cdef extern from 'numpy_interop.hpp' namespace 'pydynd':
     # Have Cython use an integer to represent the bool argument.
@@ -114,6 +152,12 @@ cdef class array(object):
         If provided, the type is used as the full type for the input.
         If needed by the type, the shape is deduced from the input.
         This parameter cannot be used together with 'dtype'.
+    layout: 'row' or 'columnar', optional
+        With 'columnar', an array of structs such as
+        "N * {a: int32, b: float64}" is stored as a struct of arrays,
+        "{a: N * int32, b: N * float64}", with each field in its own
+        contiguous block. Accessing a field, as with a.b or nd.fields,
+        is then a contiguous view. The dimensions must be fixed.
     access:  'readwrite'/'rw', 'readonly'/'r', or 'immutable', optional
         If provided, this specifies the access control for the
         created array. If the array is being allocated, as in
@@ -145,16 +189,22 @@ cdef class array(object):
              type="2 * date")
     """
 
-    def __init__(self, value = None, type = None):
+    def __init__(self, value = None, type = None, layout = 'row'):
 
+        if layout not in ('row', 'columnar'):
+            raise ValueError("layout must be 'row' or 'columnar', not %r" % (layout,))
         if value is None and type is None:
             return
 
         cdef _type dst_tp
         if type is None:
-            dst_tp = cpp_type_for(value)
-            self.v = cpp_empty(dst_tp)
-            self.v.assign(pyobject_array(value))
+            if _builtin_type(value) is list:
+                # Rectangular numeric lists are deduced and copied in one pass
+                self.v = array_from_numeric_pylist(value)
+            if self.v.is_null():
+                dst_tp = cpp_type_for(value)
+                self.v = cpp_empty(dst_tp)
+                self.v.assign(pyobject_array(value))
         else:
             from ..ndt import type as ndt_type
             if (not isinstance(type, ndt_type)):
@@ -163,6 +213,9 @@ cdef class array(object):
             self.v = cpp_empty(dst_tp)
             self.v.assign(pyobject_array(value))
 
+        if layout == 'columnar':
+            self.v = array_as_columnar(self.v)
+
     property access_flags:
         """
         a.access_flags
@@ -270,16 +323,12 @@ cdef class array(object):
         self.v.p(name).assign(pyobject_array(value))
 
     def __getitem__(self, x):
-        from .. import ndt, nd
-
         cdef array idx
-        if isinstance(x, list):
-          idx = asarray(x)
-          if (idx.dtype == ndt.bool):
-            return nd.take(self, idx)
-        elif isinstance(x, array):
-          if (x.dtype == ndt.bool):
-            return nd.take(self, x)
+        if isinstance(x, (list, array, _np.ndarray)):
+            # Integer arrays and boolean masks gather rows
+            idx = asarray(x)
+            if array_is_index_array(idx.v):
+                return dynd_nd_array_from_cpp(array_take(self.v, idx.v))
 
         cdef array result = array()
         result.v = array_getitem(self.v, x)
@@ -334,6 +383,14 @@ cdef class array(object):
         return str(<char *>array_repr(self.v).c_str())
 
     def __setitem__(self, x, y):
+        cdef array idx
+        if isinstance(x, (list, array, _np.ndarray)):
+            # Integer arrays and boolean masks scatter into rows
+            idx = asarray(x)
+            if array_is_index_array(idx.v):
+                array_put(self.v, idx.v, as_cpp_array(y))
+                return
+
         array_setitem(self.v, x, y)
 
     def __pos__(self):
@@ -468,6 +525,61 @@ cdef class array(object):
         #"""PEP 3118 buffer protocol"""
         array_releasebuffer_pep3118(self, buffer)
 
+    def __arrow_c_array__(self, requested_schema=None):
+        """
+        a.__arrow_c_array__(requested_schema=None)
+        Exports the array through the Arrow C Data Interface, as a tuple of
+        "arrow_schema" and "arrow_array" PyCapsules. Contiguous primitive
+        data is shared rather than copied. The requested schema is ignored,
+        and the array is always exported with its own type.
+        """
+        return array_as_arrow_c_array(self.v)
+
+    def __dlpack__(self, stream=None, max_version=None, dl_device=None, copy=None):
+        """
+        a.__dlpack__(stream=None, max_version=None, dl_device=None, copy=None)
+        Exports the array as a DLPack "dltensor" capsule, sharing its memory
+        unless copy is True. The array must have only fixed dimensions of a
+        numeric type, with strides that are multiples of the element size.
+        """
+        if stream is not None:
+            raise BufferError('dynd arrays are in CPU memory, so stream must be None')
+        if dl_device is not None and tuple(dl_device) != self.__dlpack_device__():
+            raise BufferError('dynd arrays can only be exported to the CPU')
+        if copy:
+            return array_as_dlpack(self.v.eval_copy())
+        return array_as_dlpack(self.v)
+
+    def __dlpack_device__(self):
+        """
+        a.__dlpack_device__()
+        Returns the DLPack (device type, device id) of the array's memory,
+        which is always the CPU.
+        """
+        return (1, 0)
+
+    @staticmethod
+    def from_arrow(obj):
+        """
+        nd.array.from_arrow(obj)
+        Imports an array through the Arrow C Data Interface. The object may
+        implement __arrow_c_array__, like a pyarrow.Array, or be the tuple
+        of PyCapsules that method returns. Primitive columns without nulls
+        are viewed without copying, and columns with nulls become option
+        types.
+        Examples
+        --------
+        >>> import pyarrow as pa
+        >>> from dynd import nd
+        >>> nd.array.from_arrow(pa.array([1, None, 3]))
+        nd.array([1, None, 3],
+                 type="3 * ?int64")
+        """
+        if hasattr(obj, '__arrow_c_array__'):
+            obj = obj.__arrow_c_array__()
+        schema_capsule, array_capsule = obj
+        return dynd_nd_array_from_cpp(array_from_arrow_c_array(schema_capsule, array_capsule))
+
     def cast(array self, tp):
         """
         a.cast(type)
@@ -612,8 +724,8 @@ cdef _array as_cpp_array(object obj) except *:
         return dynd_nd_array_to_cpp(obj)
     elif _builtin_type(obj) is _np.ndarray:
         return array_from_numpy_array_cast(<PyObject*>obj, 0, 0)
-    # elif PyObject_CheckBuffer(obj):
-    #     TODO
+    elif PyObject_CheckBuffer(obj) and _builtin_type(obj) is not bytes:
+        return array_from_pep3118_buffer(obj, 0, 0)
     cdef _type tp = cpp_type_for(obj)
     cdef _array out = cpp_empty(tp)
     out.assign(pyobject_array(obj))
@@ -724,9 +836,9 @@ def is_f_contiguous(array a):
     """
     return array_is_f_contiguous(a.v)
 
-def as_py(array n):
+def as_py(array n, intern=False):
     """
-    nd.as_py(n)
+    nd.as_py(n, intern=False)
     Evaluates the dynd array, converting it into native Python types.
     Uniform dimensions convert into Python lists, struct types convert
     into Python dicts, scalars convert into the most appropriate Python
@@ -738,6 +850,11 @@ def as_py(array n):
     tuple : bool
         If true, produce tuples instead of dicts when converting
         dynd struct arrays.
+    intern : bool
+        If true, equal numbers in the result share one Python object,
+        which saves allocations and memory when there are few distinct
+        values, such as codes or sentinels. This applies to numeric
+        arrays whose dimensions are all fixed.
     Examples
     --------
     >>> from dynd import nd, ndt
@@ -748,6 +865,10 @@ def as_py(array n):
     >>> nd.as_py(a)
     [1.0, 2.0, 3.0, 4.0]
     """
+    # Numeric arrays are converted straight into preallocated lists
+    lst = array_as_numeric_pylist(dynd_nd_array_to_cpp(n), intern)
+    if lst is not None:
+        return lst
     cdef _array res = pyobject_array(None)
     res.assign(dynd_nd_array_to_cpp(n))
     return <object> dereference(<PyObject **> res.data())
@@ -1019,9 +1140,9 @@ def old_linspace(start, stop, count=50, dtype=None):
     result.v = array_old_linspace(start, stop, count, dtype)
     return result
 
-def parse_json(tp, json, ectx=None):
+def parse_json(tp, json, ectx=None, nthreads=None):
     """
-    nd.parse_json(type, json, ectx)
+    nd.parse_json(type, json, ectx, nthreads)
     Parses an input JSON string as a particular dynd type.
     Parameters
     ----------
@@ -1032,6 +1153,12 @@ def parse_json(tp, json, ectx=None):
         String that contains the JSON to parse.
     ectx : eval_context, optional
         If provided an evaluation context to use when processing the JSON.
+    nthreads : int, optional
+        If provided, the JSON is newline-delimited, with one record per
+        line, and the type must be "var * T" or "N * T". The text is split
+        at line boundaries and parsed on up to this many threads, with 0
+        meaning one per core. Records containing var dimensions are
+        parsed on one thread.
     Examples
     --------
     >>> from dynd import nd, ndt
@@ -1046,12 +1173,299 @@ def parse_json(tp, json, ectx=None):
              type="2 * {x : int8, y : int8}")
     """
     cdef array result = array()
-    if isinstance(tp, array):
+    cdef bytes buf
+    cdef const char *data
+    if nthreads is not None:
+        buf = json if isinstance(json, bytes) else json.encode('utf-8')
+        data = buf
+        if isinstance(tp, array):
+            parse_json_lines_parallel((<array>tp).v, data, data + len(buf), nthreads)
+        else:
+            result.v = parse_json_lines_parallel(_py_type(tp).v, data, data + len(buf), nthreads)
+            return result
+    elif isinstance(tp, array):
         dynd_parse_json_array((<array>tp).v, array(json).v, ectx)
     else:
         result.v = dynd_parse_json_type(_py_type(tp).v, array(json).v, ectx)
         return result
 
+def _json_blocks(source, block_size):
+    # Yields the UTF-8 bytes of a file or an iterable of text blocks
+    if hasattr(source, 'read'):
+        while True:
+            block = source.read(block_size)
+            if not block:
+                return
+            if not isinstance(block, bytes):
+                block = block.encode('utf-8')
+            yield block
+    else:
+        for block in source:
+            if not isinstance(block, bytes):
+                block = block.encode('utf-8')
+            yield block
+
+def _parse_json_batches(tp, source, intptr_t chunk_rows, block_size):
+    cdef array batch = empty(chunk_rows, tp)
+    cdef intptr_t nrows = 0
+    cdef intptr_t consumed = 0
+    cdef intptr_t pos
+    cdef bytes buf = b''
+    cdef const char *data
+    blocks = _json_blocks(source, block_size)
+    final = False
+    while not final:
+        block = next(blocks, None)
+        if block is None:
+            final = True
+        else:
+            buf += block
+        # Parse all the complete lines, keeping any incomplete last one
+        pos = 0
+        data = buf
+        while True:
+            nrows += parse_json_lines(batch.v, nrows, data + pos, data + len(buf), final, &consumed)
+            pos += consumed
+            if nrows < chunk_rows:
+                break
+            yield batch
+            batch = empty(chunk_rows, tp)
+            nrows = 0
+        buf = buf[pos:]
+    if nrows > 0:
+        yield batch[:nrows]
+
+def parse_json_stream(tp, source, chunk_rows=65536, batches=False, block_size=1 << 20):
+    """
+    nd.parse_json_stream(type, source, chunk_rows=65536, batches=False)
+    Parses newline-delimited JSON, one record of the given type per line,
+    reading the text incrementally so it never needs to be in memory all
+    at once.
+    Parameters
+    ----------
+    type : dynd type
+        The type of one record.
+    source : file or iterable
+        A file opened for reading, or an iterable of str or bytes blocks,
+        which need not end at line boundaries.
+    chunk_rows : int, optional
+        The number of records parsed into each batch.
+    batches : bool, optional
+        If True, returns an iterator over arrays of up to chunk_rows
+        records instead of one array of all of them, so memory use stays
+        bounded by the batch size.
+    block_size : int, optional
+        The number of bytes read from a file at a time.
+    Examples
+    --------
+    >>> from dynd import nd
+    >>> nd.parse_json_stream('{x: int32}', ['{"x": 1}\\n{"x"', ': 2}\\n'])
+    nd.array([[1], [2]],
+             type="2 * {x : int32}")
+    """
+    tp = _py_type(tp)
+    if chunk_rows <= 0:
+        raise ValueError('chunk_rows must be positive')
+    gen = _parse_json_batches(tp, source, chunk_rows, block_size)
+    if batches:
+        return gen
+
+    # Append the batches into a result which doubles in size when full
+    cdef intptr_t n = 0
+    cdef intptr_t k
+    result = None
+    for batch in gen:
+        k = len(batch)
+        if result is None:
+            result = batch
+        else:
+            if n + k > len(result):
+                grown = empty(max(2 * len(result), n + k), tp)
+                grown[:n] = result[:n]
+                result = grown
+            result[n:n + k] = batch
+        n += k
+    if result is None:
+        return empty(0, tp)
+    return result[:n]
+
+def string_offsets(array a, large=False):
+    """
+    nd.string_offsets(a, large=False)
+    Converts a one-dimensional array of strings into the Arrow string
+    layout, without creating any Python string objects.
+    Parameters
+    ----------
+    a : dynd array
+        An array of type "N * string".
+    large : bool, optional
+        If True, the offsets are int64 instead of int32. Data of 2 GiB
+        or more requires this.
+    Returns
+    -------
+    (offsets, data) : tuple of dynd arrays
+        The N + 1 offsets and the UTF-8 bytes of all the strings, with
+        string i being data[offsets[i]:offsets[i + 1]]. Both support the
+        buffer protocol, so numpy.asarray views them without a copy.
+    Examples
+    --------
+    >>> from dynd import nd
+    >>> offsets, data = nd.string_offsets(nd.array(['abc', '', 'de']))
+    >>> offsets
+    nd.array([0, 3, 3, 5],
+             type="4 * int32")
+    """
+    cdef pair[_array, _array] res = array_as_string_offsets(a.v, large)
+    cdef array offsets = array()
+    cdef array data = array()
+    offsets.v = res.first
+    data.v = res.second
+    return offsets, data
+
+def categorical_codes(array a):
+    """
+    nd.categorical_codes(a)
+    Splits an array of categorical type into its integer codes and its
+    categories, the layout of pandas.Categorical, without creating a
+    Python object per element.
+    Parameters
+    ----------
+    a : dynd array
+        An array whose dtype is categorical.
+    Returns
+    -------
+    (codes, categories) : tuple of dynd arrays
+        A read-only view of the codes, with the same shape as the array
+        and the categorical's unsigned integer storage type, and the
+        one-dimensional array of categories, where code i stands for
+        categories[i].
+    Examples
+    --------
+    >>> import numpy as np, pandas as pd
+    >>> from dynd import nd
+    >>> a = nd.from_categorical_codes([0, 1, 0], ['low', 'high'])
+    >>> codes, categories = nd.categorical_codes(a)
+    >>> pd.Categorical.from_codes(np.asarray(codes), nd.as_py(categories))
+    [low, high, low]
+    Categories (2, object): [low, high]
+    """
+    cdef pair[_array, _array] res = array_as_categorical_codes(a.v)
+    cdef array codes = array()
+    cdef array categories = array()
+    codes.v = res.first
+    categories.v = res.second
+    return codes, categories
+
+def from_categorical_codes(codes, categories):
+    """
+    nd.from_categorical_codes(codes, categories)
+    Makes a one-dimensional categorical array from integer codes and the
+    categories they index, like the codes and categories of a
+    pandas.Categorical. This is the inverse of nd.categorical_codes.
+    Parameters
+    ----------
+    codes : array-like
+        One-dimensional integer codes. If they are read-only, contiguous
+        and of the categorical's storage type, uint8 for up to 256
+        categories, uint16 for up to 65536 and uint32 otherwise, the result
+        is a read-only view of them, otherwise they are copied. Every code
+        must be in the range [0, len(categories)), so missing values, which
+        pandas codes as -1, aren't supported.
+    categories : array-like
+        The one-dimensional unique categories.
+    Examples
+    --------
+    >>> import numpy as np
+    >>> from dynd import nd
+    >>> nd.from_categorical_codes(np.array([1, 0, 1], dtype=np.int8), ['a', 'b'])
+    nd.array(["b", "a", "b"],
+             type="3 * categorical[string, [\"a\", \"b\"]]")
+    """
+    cdef array result = array()
+    result.v = array_from_categorical_codes(as_cpp_array(codes), as_cpp_array(categories))
+    return result
+
+def memmap(path, type=None, mode='r'):
+    """
+    nd.memmap(path, type=None, mode='r')
+    Maps a file into memory as a dynd array, without reading it. The OS
+    pages the data in as it is accessed, and processes mapping the same
+    file share its pages. The file starts with a small header recording
+    the array's type, followed by the C-contiguous data.
+    Parameters
+    ----------
+    path : string
+        The path of the file.
+    type : dynd type, optional
+        The type of the array, with fixed dimensions and a dtype such as a
+        number or a fixed-size string. This is required to create a file.
+        For an existing file, the type is read from its header, and if
+        given must match it.
+    mode : 'r', 'r+', 'c' or 'w+', optional
+        'r' maps an existing file read only, 'r+' maps it for reading and
+        writing, and 'c' maps it copy on write, so changes aren't written
+        back. 'w+' creates the file, replacing any existing one, with the
+        data filled with zeros.
+    Examples
+    --------
+    >>> from dynd import nd
+    >>> a = nd.memmap('features.dynd', '1000 * 64 * float32', 'w+')
+    >>> a[0, :3] = [1, 2, 3]
+    >>> del a
+    >>> nd.memmap('features.dynd')[0, :3]
+    nd.array([1, 2, 3],
+             type="3 * float32")
+    """
+    cdef _type tp
+    if type is not None:
+        tp = _py_type(type).v
+    if not isinstance(path, bytes):
+        path = path.encode(sys.getfilesystemencoding() or 'utf-8')
+    cdef array result = array()
+    result.v = array_memmap(path, tp, mode.encode('ascii'))
+    return result
+
+def from_dlpack(obj):
+    """
+    nd.from_dlpack(obj)
+    Views a tensor from another library through DLPack, without copying.
+    The object may implement __dlpack__, like NumPy arrays and PyTorch
+    tensors on the CPU, or be a "dltensor" PyCapsule.
+    Examples
+    --------
+    >>> import numpy as np
+    >>> from dynd import nd
+    >>> nd.from_dlpack(np.arange(3.0))
+    nd.array([0, 1, 2],
+             type="3 * float64")
+    """
+    if hasattr(obj, '__dlpack__'):
+        obj = obj.__dlpack__()
+    return dynd_nd_array_from_cpp(array_from_dlpack(obj))
+
+def from_string_offsets(offsets, data):
+    """
+    nd.from_string_offsets(offsets, data)
+    Converts the Arrow string layout into a one-dimensional array of
+    strings. This is the inverse of nd.string_offsets.
+    Parameters
+    ----------
+    offsets : array-like
+        The N + 1 int32 or int64 offsets into the data.
+    data : array-like
+        The contiguous uint8 bytes of the strings, for example a NumPy
+        array or any object supporting the buffer protocol.
+    Examples
+    --------
+    >>> from dynd import nd
+    >>> nd.from_string_offsets([0, 3, 3, 5], bytearray(b'abcde'))
+    nd.array(["abc", "", "de"],
+             type="3 * string")
+    """
+    cdef array result = array()
+    result.v = array_from_string_offsets(as_cpp_array(offsets), as_cpp_array(data))
+    return result
+
 import operator
 
 def _validate_squeeze_index(i, sz):
@@ -1134,10 +1548,20 @@ from .callable cimport wrap
 # making them available where they are actually needed.
 
 cdef extern from 'functional.hpp':
-    _callable _apply 'apply'(_type, object) except +translate_exception
+    _callable _apply 'apply'(_type, object, bint) except +translate_exception
+
+cdef _callable _functional_apply(_type t, object o, bint batch=False) except *:
+    return _apply(t, o, batch)
+
+cdef extern from 'ufunc_callables.hpp' namespace 'pydynd':
+    vector[_callable] ufunc_loop_callables(object) except +translate_exception
+
+cdef list _functional_ufunc_loops(object ufunc):
+    cdef vector[_callable] loops = ufunc_loop_callables(ufunc)
+    return [wrap(loops[i]) for i in range(loops.size())]
 
-cdef _callable _functional_apply(_type t, object o) except *:
-    return _apply(t, o)
+cdef bint _type_contains_pyobject(_type tp) nogil:
+    return type_contains_pyobject(tp)
 
 cdef extern from 'assign.hpp':
     void assign_init() except +translate_exception
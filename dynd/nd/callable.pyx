@@ -9,7 +9,7 @@ from cython.operator cimport dereference
 
 from ..config cimport translate_exception
 from ..cpp.callable cimport const_charptr, stringstream
-from .array cimport as_cpp_array, dynd_nd_array_from_cpp
+from .array cimport as_cpp_array, dynd_nd_array_from_cpp, _type_contains_pyobject
 from ..cpp.type cimport type as _type
 
 cdef extern from *:
@@ -20,6 +20,9 @@ cdef extern from *:
 
 ctypedef pair[const_charptr, _array] char_array_pair
 
+cdef extern from 'callable_functions.hpp' namespace 'pydynd':
+    _array callable_call(_callable&, size_t, _array*, size_t, char_array_pair*, bint) except +translate_exception
+
 cdef class callable(object):
     """
     nd.callable(func, proto)
@@ -50,6 +53,12 @@ cdef class callable(object):
       File "<stdin>", line 1, in <module>
       File "config.pyx", line 1340, in config.callable.__call__ (config.cxx:9774)
     ValueError: parameter 2 to callable does not match, expected int32, received string
+
+    When none of the types involved in a call are ``pyobject``, the GIL is
+    released while the kernel runs, so other Python threads can make
+    progress. Kernels wrapping Python functions reacquire it as needed.
+    Passing ``release_gil=False`` keeps the GIL held for the whole call,
+    for kernels which are known to call back into Python without doing so.
     """
 
     property type:
@@ -71,6 +80,7 @@ cdef class callable(object):
             return [(wrap(kwd.first), kwd.second) for kwd in kwds]
 
     def __call__(callable self, *args, **kwargs):
+        cdef bint release_gil = kwargs.pop('release_gil', True)
         cdef size_t nargs = len(args), nkwargs = len(kwargs)
         cdef vector[_array] cpp_args
         cpp_args.reserve(nargs)
@@ -87,8 +97,11 @@ cdef class callable(object):
                 s_tmp = s.encode('UTF-8')
                 cpp_kwargs.push_back(char_array_pair(
                     <const_char*>s_tmp, as_cpp_array(ar)))
-        a = dynd_nd_array_from_cpp(dynd_nd_callable_to_cpp(self).call(
-                   nargs, cpp_args.data(), nkwargs, cpp_kwargs.data()))
+        if release_gil:
+            release_gil = not _requires_gil(self.v, cpp_args, cpp_kwargs)
+        a = dynd_nd_array_from_cpp(callable_call(
+                   dereference(dynd_nd_callable_to_ptr(self)), nargs, cpp_args.data(),
+                   nkwargs, cpp_kwargs.data(), release_gil))
         return a
 
     def __repr__(self):
@@ -97,6 +110,32 @@ cdef class callable(object):
 
         return ss.str()
 
+cdef bint _requires_gil(_callable &f, vector[_array] &args,
+                        vector[char_array_pair] &kwargs):
+    """
+    Returns True if the signature of ``f``, or any of the arguments it is
+    being called with, involves ``pyobject`` values, whose kernels
+    manipulate Python objects directly.
+    """
+    cdef size_t i
+    cdef vector[_type] arg_tps = dereference(f).get_arg_types()
+    cdef vector[pair[_type, string]] kwd_tps = dereference(f).get_kwd_types()
+    if _type_contains_pyobject(dereference(f).get_ret_type()):
+        return True
+    for i in range(arg_tps.size()):
+        if _type_contains_pyobject(arg_tps[i]):
+            return True
+    for i in range(kwd_tps.size()):
+        if _type_contains_pyobject(kwd_tps[i].first):
+            return True
+    for i in range(args.size()):
+        if _type_contains_pyobject(args[i].get_type()):
+            return True
+    for i in range(kwargs.size()):
+        if _type_contains_pyobject(kwargs[i].second.get_type()):
+            return True
+    return False
+
 cdef _callable dynd_nd_callable_to_cpp(callable c) nogil except *:
     # Once this becomes a method of the type wrapper class, this check and
     # its corresponding exception handler declaration are no longer necessary
@@ -1,4 +1,4 @@
-from libc.stdint cimport intptr_t
+from libc.stdint cimport intptr_t, int64_t
 from libcpp.vector cimport vector
 from cpython cimport PyObject
 
@@ -9,37 +9,86 @@ from ..cpp.functional cimport elwise as _elwise
 from ..cpp.functional cimport reduction as _reduction
 from ..cpp.array cimport array as _array
 from ..cpp.type cimport make_type
+from ..cpp.types.type_id cimport type_id_t
 
 from ..config cimport translate_exception
-from .array cimport _functional_apply as _apply
+from .array cimport _functional_apply as _apply, _functional_ufunc_loops as _ufunc_loops
 from .callable cimport callable, wrap, dynd_nd_callable_to_cpp
 from ..ndt.type cimport type, as_numba_type, from_numba_type, as_cpp_type
 
+import numpy as _np
+
 cdef extern from 'dynd/functional.hpp' namespace 'dynd::nd::functional':
     _callable _dispatch 'dynd::nd::functional::dispatch'[T](_type, T) \
         except +translate_exception
-    _callable _multidispatch 'dynd::nd::functional::multidispatch'[T](_type, T, T) \
-        except +translate_exception
 
 cdef extern from 'dynd/callable.hpp' namespace 'dynd::nd':
     _callable _make_callable 'dynd::nd::make_callable'[T](_type, object, ...) except +translate_exception
 
+cdef extern from "callables/parallel_elwise_callable.hpp" namespace "pydynd::nd::functional":
+    _callable _parallel_elwise "pydynd::nd::functional::parallel_elwise"(_callable, intptr_t, intptr_t) \
+        except +translate_exception
+
+cdef extern from "thread_pool.hpp" namespace "pydynd":
+    cdef cppclass thread_pool:
+        int64_t get_nloops()
+        int64_t get_nchunks()
+
+    thread_pool &get_thread_pool()
+
+cdef extern from "callables/parallel_reduction_callable.hpp" namespace "pydynd::nd::functional":
+    _callable _parallel_reduction "pydynd::nd::functional::parallel_reduction"(_callable, intptr_t, intptr_t) \
+        except +translate_exception
+
+cdef extern from "callables/cached_dispatch_callable.hpp" namespace "pydynd::nd::functional":
+    _callable _cached_dispatch "pydynd::nd::functional::cached_dispatch"(const _type &, const vector[_callable] &) \
+        except +translate_exception
+    bint _get_dispatch_stats "pydynd::nd::functional::get_dispatch_stats"(const _callable &, int64_t *, int64_t *,
+                                                                             int64_t *)
+    bint _clear_dispatch_cache "pydynd::nd::functional::clear_dispatch_cache"(const _callable &)
+
 cdef extern from "callables/apply_jit_callable.hpp" namespace "pydynd::nd::functional":
-    _callable _apply_jit "pydynd::nd::functional::apply_jit"(const _type &tp, intptr_t)
+    _callable _apply_jit "pydynd::nd::functional::apply_jit"(const _type &tp, intptr_t) \
+        except +translate_exception
 
     cdef cppclass apply_jit_dispatch_callable:
         apply_jit_dispatch_callable(object, object (*)(object, intptr_t, const _type *))
 
-def _import_numba():
+# The compiled code must outlive the callables which point into it
+_jit_libraries = []
+
+def _numba_target_context():
     try:
-        import numba
+        from numba.core.registry import cpu_target
     except ImportError:
-        return False
+        from numba.targets.registry import cpu_target
+    return cpu_target.target_context
 
-    return False
+def _load_jit_library(cached):
+    try:
+        return _numba_target_context().codegen().unserialize_library(cached[1])
+    except Exception:
+        # An entry written by an incompatible Numba is just a miss
+        return None
+
+def _load_cached_jit(key):
+    """
+    Returns the (return type id, library) of the compiled code cached for
+    ``key``, or None if it has to be compiled.
+    """
+    from . import jit_cache
+
+    cached = jit_cache.load(key)
+    if cached is None:
+        return None
+    library = _load_jit_library(cached)
+    if library is None:
+        return None
+    return cached[0], library
 
 cdef public object _jit(object func, intptr_t nsrc, const _type *src_tp):
     from llvmlite import ir
+    from . import jit_cache
 
     CharType = ir.IntType(8)
     CharPointerType = CharType.as_pointer()
@@ -68,74 +117,354 @@ cdef public object _jit(object func, intptr_t nsrc, const _type *src_tp):
 
         return single
 
-    # This is the Numba signature
-    signature = tuple(as_numba_type(src_tp[i]) for i in range(nsrc))
-
-    # Compile the function with Numba
-    func.compile(signature)
-    compile_res = func.overloads[signature]
-
-    # Check if there is a corresponding return type in DyND
-    cdef _type dst_tp = from_numba_type(compile_res.signature.return_type)
-
-    # The following generates the wrapper function using LLVM IR
-    fndesc = compile_res.fndesc
-    target_context = compile_res.target_context
-    library = target_context.codegen().create_library(name = 'library')
-
-    ir_module = library.create_ir_module(name = 'module')
-#    memcpy = ir_module.declare_intrinsic('llvm.memcpy',
- #       [CharPointerType, CharPointerType, Int32Type])
-
-    wrapped_func_ir_tp = target_context.call_conv.get_function_type(fndesc.restype,
-        fndesc.argtypes)
-    wrapped_func = ir_module.get_or_insert_function(wrapped_func_ir_tp,
-        name = fndesc.llvm_func_name)
-
-    single = add_single_ir(ir_module)
-
-    library.add_ir_module(ir_module)
-    library.finalize()
-
     cdef vector[_type] src_tp_copy
     for i in range(nsrc):
         src_tp_copy.push_back(src_tp[i])
 
+    cdef _type dst_tp
+    # Warm starts load the compiled code from disk instead of compiling
+    key = jit_cache.key(func, [src_tp[i].get_id() for i in range(nsrc)])
+    cached = _load_cached_jit(key)
+    if cached is not None:
+        dst_tp = _type(<type_id_t> cached[0])
+        library = cached[1]
+    else:
+        # This is the Numba signature
+        signature = tuple(as_numba_type(src_tp[i]) for i in range(nsrc))
+
+        # Compile the function with Numba
+        func.compile(signature)
+        compile_res = func.overloads[signature]
+
+        # Check if there is a corresponding return type in DyND
+        dst_tp = from_numba_type(compile_res.signature.return_type)
+
+        # The following generates the wrapper function using LLVM IR
+        fndesc = compile_res.fndesc
+        target_context = compile_res.target_context
+        library = target_context.codegen().create_library(name = 'library')
+
+        ir_module = library.create_ir_module(name = 'module')
+#        memcpy = ir_module.declare_intrinsic('llvm.memcpy',
+ #           [CharPointerType, CharPointerType, Int32Type])
+
+        wrapped_func_ir_tp = target_context.call_conv.get_function_type(fndesc.restype,
+            fndesc.argtypes)
+        wrapped_func = ir_module.get_or_insert_function(wrapped_func_ir_tp,
+            name = fndesc.llvm_func_name)
+
+        single = add_single_ir(ir_module)
+
+        # Link in the compiled function, so the library is self-contained
+        # when it is serialized for the cache
+        library.add_linking_library(compile_res.library)
+        library.add_ir_module(ir_module)
+        library.finalize()
+
+        try:
+            jit_cache.store(key, dst_tp.get_id(), library.serialize_using_object_code())
+        except Exception:
+            pass
+
+    _jit_libraries.append(library)
+
     return wrap(_apply_jit(make_type[_callable_type](dst_tp, src_tp_copy),
             library.get_pointer_to_function('single')))
 
-def apply(func = None, jit = _import_numba(), *args, **kwds):
+def _annotated_type(func):
+    """
+    Returns the callable type of the Python function ``func``, made from
+    its annotations. Unannotated arguments and the return are ``Scalar``.
+    """
     from .. import ndt
+
+    annotations = getattr(func, '__annotations__', {})
+    code = func.__code__
+    args = [annotations.get(name, ndt.scalar) for name in code.co_varnames[:code.co_argcount]]
+    ret = annotations.get('return', ndt.scalar)
+    return ndt.type('(%s) -> %s' % (', '.join(str(ndt.type(tp)) for tp in args), ndt.type(ret)))
+
+def apply(func = None, jit = False, *args, **kwds):
+    """
+    nd.functional.apply(func, jit=False, batch=False)
+
+    Makes a callable from the Python function ``func``, whose types come
+    from its annotations.
+
+    With ``jit=True``, ``func`` is compiled with Numba for each combination
+    of argument types it is called with, and the compiled code is cached on
+    disk, as described in ``dynd.nd.jit_cache``.
+
+    With ``batch=True``, an elementwise lifted call passes ``func`` 1D
+    strided arrays holding whole runs of elements, once per run instead
+    of once per element, and ``func`` returns an array of the results
+    (or a scalar, which is broadcast). The argument arrays are only valid
+    during the call. Batch mode never uses the JIT.
+    """
+    batch = kwds.pop('batch', False)
     def make(type tp, func):
-        if jit:
+        if jit and not batch:
             import numba
             return wrap(_make_callable[apply_jit_dispatch_callable]((<type> tp).v,
                 <object> numba.jit(func, *args, **kwds), _jit))
 
-        return wrap(_apply(tp.v, func))
+        return wrap(_apply(tp.v, func, batch))
 
     if func is None:
-        return lambda func: make(ndt.callable(func), func)
+        return lambda func: make(_annotated_type(func), func)
 
-    return make(ndt.callable(func), func)
+    return make(_annotated_type(func), func)
+
+def elwise(func = None, nthreads = None, grain = 0):
+    """
+    nd.functional.elwise(func, nthreads=None, grain=0)
+
+    Lifts ``func`` to operate elementwise over array dimensions.
+
+    If ``nthreads`` is given, calls whose arguments share an outermost
+    fixed dimension split that dimension into chunks of ``grain``
+    elements, which are run on a pool of up to ``nthreads`` threads.
+    ``nthreads=0`` uses one thread per core, and ``grain=0`` picks a
+    chunk size from the dimension size.
+    """
+    if func is None:
+        return lambda func: elwise(func, nthreads, grain)
 
-def elwise(func):
     if not isinstance(func, callable):
         func = apply(func)
 
-    return wrap(_elwise((<callable> func).v))
+    cdef _callable c = _elwise((<callable> func).v)
+    if nthreads is not None:
+        c = _parallel_elwise(c, nthreads, grain)
 
-def reduction(identity, child):
+    return wrap(c)
+
+def thread_pool_stats():
+    """
+    nd.functional.thread_pool_stats()
+
+    Returns a dict with the number of ``loops`` which the thread pool
+    behind ``elwise`` and ``parallel_reduction`` has run on more than one
+    thread, and the number of ``chunks`` those loops were split into.
+    Calls which ran serially aren't counted.
+    """
+    return {'loops': get_thread_pool().get_nloops(),
+            'chunks': get_thread_pool().get_nchunks()}
+
+def reduction(identity, child, nthreads = None, grain = 0):
+    """
+    nd.functional.reduction(identity, child, nthreads=None, grain=0)
+
+    Makes a callable which reduces array dimensions by folding the binary
+    ``child`` over their elements, starting from ``identity``.
+
+    If ``nthreads`` is given, the reduction runs in parallel as described
+    for ``parallel_reduction``, which requires ``child`` to be associative.
+    """
     if not isinstance(child, callable):
         child = apply(child)
 
-    return wrap(_reduction((<callable> identity).v, (<callable> child).v))
+    cdef _callable c = _reduction((<callable> identity).v, (<callable> child).v)
+    if nthreads is not None:
+        c = _parallel_reduction(c, nthreads, grain)
+
+    return wrap(c)
+
+def parallel_reduction(func, nthreads = 0, grain = 0):
+    """
+    nd.functional.parallel_reduction(func, nthreads=0, grain=0)
+
+    Wraps the reduction callable ``func``, such as ``nd.sum``, so calls
+    which reduce all of an array of fixed dimensions to a scalar run on a
+    pool of up to ``nthreads`` threads. ``nthreads=0`` uses one thread per
+    core.
+
+    The outermost dimension is split into blocks of ``grain`` rows, and
+    ``grain=0`` picks a block size from the array size. Each block is
+    reduced on its own starting from the identity, and the block results
+    are then reduced together, so ``func`` must be associative. For
+    floating point sums, this also reduces the rounding error compared to
+    a single left to right sum.
+
+    Calls with keyword arguments, like ``axes``, go straight to ``func``.
+    """
+    if grain < 0:
+        raise ValueError('grain must not be negative, not %d' % grain)
+
+    return wrap(_parallel_reduction((<callable> func).v, nthreads, grain))
+
+# The default number of bytes in each chunk reduce_chunks slices from an
+# array
+_REDUCE_CHUNK_BYTES = 16 << 20
+
+def _iter_row_chunks(a, chunk_rows):
+    from .. import nd
+
+    n = len(a)
+    if chunk_rows is None:
+        row_size = 1
+        if n > 0:
+            row_size = max(1, nd.type_of(nd.asarray(a[0:1])).data_size)
+        chunk_rows = max(1, _REDUCE_CHUNK_BYTES // row_size)
+    elif chunk_rows <= 0:
+        raise ValueError('chunk_rows must be positive, not %d' % chunk_rows)
+
+    for i in range(0, n, chunk_rows):
+        yield a[i:i + chunk_rows]
+
+def _combine_partials(func, acc, partial):
+    from .. import nd
+
+    # Reduce the running result and the new one along a new outer dimension
+    pair = nd.empty(2, nd.type_of(partial))
+    pair[0] = acc
+    pair[1] = partial
+    return func(pair, axes = [0])
+
+def reduce_chunks(func, chunks, axes = None, chunk_rows = None):
+    """
+    nd.functional.reduce_chunks(func, chunks, axes=None, chunk_rows=None)
+
+    Applies the reduction callable ``func``, such as ``nd.sum`` or one made
+    by ``nd.functional.reduction``, to an array which is given as a
+    sequence of chunks along its outermost dimension, so only one chunk
+    has to be in memory at a time.
+
+    ``chunks`` is either an iterable of arrays, like the blocks read from
+    a stream, or a single array such as one from ``nd.memmap``, which is
+    sliced into chunks of ``chunk_rows`` rows (by default about 16 MB
+    each). Each chunk is reduced on its own and folded into a running
+    result by reducing the two together, which requires ``func`` to be
+    associative.
+
+    If ``axes`` leaves the outermost dimension unreduced, the result has
+    a row per input row, and is assembled from the partial results once
+    all the chunks have been seen.
+    """
+    from .. import nd
+
+    if isinstance(chunks, (nd.array, _np.ndarray)):
+        chunks = _iter_row_chunks(chunks, chunk_rows)
+
+    acc = None
+    partials = []
+    ndim = None
+    for chunk in chunks:
+        chunk = nd.asarray(chunk)
+        if ndim is None:
+            ndim = nd.ndim_of(chunk)
+            if ndim == 0:
+                raise ValueError('reduce_chunks requires chunks with at '
+                                 'least one dimension')
+            if axes is not None:
+                axes = sorted(set(ax % ndim for ax in axes))
+        elif nd.ndim_of(chunk) != ndim:
+            raise ValueError('reduce_chunks requires chunks with the same '
+                             'number of dimensions, got %d and %d' %
+                             (ndim, nd.ndim_of(chunk)))
+
+        if axes is None:
+            partial = func(chunk)
+        else:
+            partial = func(chunk, axes = axes)
+
+        if axes is not None and axes[0] != 0:
+            partials.append(partial)
+        elif acc is None:
+            acc = partial
+        else:
+            acc = _combine_partials(func, acc, partial)
+
+    if ndim is None:
+        raise ValueError('reduce_chunks requires at least one chunk')
+    if acc is not None:
+        return acc
+
+    rows = sum(len(p) for p in partials)
+    result = nd.empty(rows, nd.type_of(partials[0][0]))
+    start = 0
+    for p in partials:
+        result[start:start + len(p)] = p
+        start += len(p)
+    return result
 
-"""
 def multidispatch(type tp, iterable = None):
+    """
+    nd.functional.multidispatch(tp, iterable=None)
+
+    Makes a callable of type ``tp`` which forwards each call to the first
+    callable in ``iterable`` whose signature matches the argument types.
+    The callables are tried in the order given, not sorted by how specific
+    their signatures are, so put the more specific ones first.
+
+    The callable picked for each combination of argument types is cached,
+    keyed on the type ids of the arguments' dimensions and dtypes, so
+    repeated calls skip the matching. The sizes of fixed dimensions are
+    only part of the key if some signature asks for a particular size.
+    Arguments whose dtype isn't builtin are matched on every call. The
+    cache is emptied when it fills up. It is shared between threads, and
+    ``dispatch_stats`` reports how well it is doing.
+    """
     cdef vector[_callable] v
     if iterable is not None:
         for c in iterable:
             v.push_back(dynd_nd_callable_to_cpp(c))
-    return wrap(_multidispatch(as_cpp_type(tp), v.begin(), v.end()))
-"""
+    return wrap(_cached_dispatch(as_cpp_type(tp), v))
+
+def dispatch_stats(callable f):
+    """
+    nd.functional.dispatch_stats(f)
+
+    Returns a dict with the number of ``hits`` and ``misses`` of the
+    dispatch cache of ``f``, a callable made by ``multidispatch``, and the
+    number of argument type combinations it holds as ``size``.
+    """
+    cdef int64_t hits, misses, size
+    if not _get_dispatch_stats(f.v, &hits, &misses, &size):
+        raise TypeError('the callable was not made by nd.functional.multidispatch')
+    return {'hits': hits, 'misses': misses, 'size': size}
+
+def clear_dispatch_cache(callable f):
+    """
+    nd.functional.clear_dispatch_cache(f)
+
+    Empties the dispatch cache of ``f``, a callable made by
+    ``multidispatch``, and resets its counters.
+    """
+    if not _clear_dispatch_cache(f.v):
+        raise TypeError('the callable was not made by nd.functional.multidispatch')
+
+def from_ufunc(ufunc):
+    """
+    nd.functional.from_ufunc(ufunc)
+
+    Makes an elementwise callable from a NumPy ufunc with one output,
+    such as ``numpy.add``, which runs the ufunc's inner loops directly on
+    dynd arrays.
+
+    There is a child callable for each entry in ``ufunc.types`` whose
+    types have builtin dynd equivalents, and the ones for a call are
+    picked by ``multidispatch`` from the argument types. Unlike NumPy, no
+    casting is done to find a loop, so the arguments have to match one
+    of the loop signatures exactly.
+
+    Examples
+    --------
+    >>> import numpy as np
+    >>> from dynd import nd
+    >>> add = nd.functional.from_ufunc(np.add)
+    >>> add(nd.array([1.5, 2.5]), nd.array([1.0, 2.0]))
+    nd.array([2.5, 4.5],
+             type="2 * float64")
+    """
+    from .. import ndt
+
+    loops = _ufunc_loops(ufunc)
+    if not loops:
+        raise TypeError('the ufunc %s has no loops on builtin dynd types' %
+                        ufunc.__name__)
+
+    # A separate type variable for each argument and the return, since the
+    # loops needn't use the same type throughout, as in ldexp or less
+    tp = ndt.type('(%s) -> R' % ', '.join(['A%d' % i for i in range(ufunc.nin)]))
+    return elwise(multidispatch(tp, loops))
@@ -0,0 +1,206 @@
+"""
+A persistent on-disk cache of functions compiled by nd.functional.apply
+with jit=True, so a new process can skip recompiling them with Numba.
+
+Entries are keyed by a hash of the Python function's bytecode and the
+type ids of the arguments it was specialized for, together with the
+Python, Numba and DyND versions and the host CPU. Numba freezes the
+values of closure cells, default arguments and globals into the compiled
+code, so those values are part of the key too. A function which refers
+to a value the key can't capture, like an arbitrary object, is never
+cached.
+
+The cache directory is $DYND_JIT_CACHE_DIR if set, otherwise dynd/jit
+under $XDG_CACHE_HOME (or ~/.cache). Setting DYND_JIT_CACHE_DIR to an
+empty string disables the cache.
+"""
+
+from __future__ import absolute_import, division, print_function
+
+import hashlib
+import marshal
+import os
+import os.path
+import platform
+import sys
+import tempfile
+import types
+
+try:
+    import cPickle as pickle
+except ImportError:
+    import pickle
+
+__all__ = ['cache_dir', 'key', 'load', 'store', 'clear']
+
+_SUFFIX = '.dyndjit'
+
+def cache_dir():
+    """
+    Returns the directory entries are stored in, or None if the cache is
+    disabled.
+    """
+    path = os.environ.get('DYND_JIT_CACHE_DIR')
+    if path is None:
+        base = os.environ.get('XDG_CACHE_HOME') or \
+            os.path.join(os.path.expanduser('~'), '.cache')
+        path = os.path.join(base, 'dynd', 'jit')
+    return path or None
+
+def _code_of(func):
+    # Numba dispatchers wrap the original function
+    func = getattr(func, 'py_func', func)
+    return getattr(func, '__code__', None)
+
+class _Uncacheable(Exception):
+    pass
+
+_CONSTANT_TYPES = (type(None), bool, int, float, complex, str, bytes)
+try:
+    _CONSTANT_TYPES += (long, unicode)
+except NameError:
+    pass
+
+def _names_of(code):
+    names = set(code.co_names)
+    for const in code.co_consts:
+        if isinstance(const, types.CodeType):
+            names |= _names_of(const)
+    return names
+
+def _value_key(value, seen):
+    """
+    Returns a description of a value a compiled function depends on,
+    which stays the same exactly when the compiled code would.
+    """
+    if isinstance(value, _CONSTANT_TYPES):
+        return (type(value).__name__, repr(value))
+    if isinstance(value, tuple):
+        return ('tuple',) + tuple(_value_key(v, seen) for v in value)
+    if isinstance(value, types.ModuleType):
+        return ('module', value.__name__)
+    if isinstance(value, (type, types.BuiltinFunctionType)):
+        return ('named', getattr(value, '__module__', None),
+                getattr(value, '__qualname__', value.__name__))
+    if _code_of(value) is not None:
+        # Functions it calls are compiled into it, with their own globals
+        return ('function', _function_key(value, seen))
+    raise _Uncacheable()
+
+def _function_key(func, seen):
+    func = getattr(func, 'py_func', func)
+    if id(func) in seen:
+        return 'recursive'
+    seen.add(id(func))
+
+    code = func.__code__
+    parts = [marshal.dumps(code)]
+    for cell in (getattr(func, '__closure__', None) or ()):
+        try:
+            contents = cell.cell_contents
+        except ValueError:
+            # A cell which hasn't been assigned yet
+            raise _Uncacheable()
+        parts.append(_value_key(contents, seen))
+    parts.append(_value_key(getattr(func, '__defaults__', None) or (), seen))
+
+    func_globals = getattr(func, '__globals__', {})
+    builtins_dict = func_globals.get('__builtins__', {})
+    if isinstance(builtins_dict, types.ModuleType):
+        builtins_dict = builtins_dict.__dict__
+    for name in sorted(_names_of(code)):
+        # Names which are only attributes, like the sqrt of math.sqrt,
+        # aren't found and don't matter
+        if name in func_globals:
+            parts.append((name, _value_key(func_globals[name], seen)))
+        elif name in builtins_dict:
+            parts.append((name, _value_key(builtins_dict[name], seen)))
+
+    h = hashlib.sha1()
+    for part in parts:
+        h.update(part if isinstance(part, bytes) else repr(part).encode('utf-8'))
+    return h.hexdigest()
+
+def _host_cpu():
+    # Code compiled for one CPU may use instructions another doesn't have
+    from llvmlite import binding
+    return (os.environ.get('NUMBA_CPU_NAME') or binding.get_host_cpu_name(),
+            os.environ.get('NUMBA_CPU_FEATURES') or
+            binding.get_host_cpu_features().flatten())
+
+def key(func, type_ids):
+    """
+    Returns the cache key for ``func`` specialized to arguments with the
+    given type ids, or None if it can't be cached, either because it has
+    no bytecode or because it depends on a value the key can't describe.
+    """
+    if _code_of(func) is None:
+        return None
+    try:
+        function_key = _function_key(func, set())
+    except _Uncacheable:
+        return None
+
+    import numba
+    from .. import config
+
+    h = hashlib.sha1()
+    h.update(function_key.encode('utf-8'))
+    h.update(repr((tuple(int(i) for i in type_ids), sys.version,
+                   platform.machine(), _host_cpu(), numba.__version__,
+                   config._dynd_version_string)).encode('utf-8'))
+    return h.hexdigest()
+
+def _path(k):
+    return os.path.join(cache_dir(), k + _SUFFIX)
+
+def load(k):
+    """
+    Returns the (return type id, serialized library) stored for the key
+    ``k``, or None if there is no usable entry.
+    """
+    if k is None or cache_dir() is None:
+        return None
+    try:
+        with open(_path(k), 'rb') as f:
+            return pickle.load(f)
+    except Exception:
+        # A missing, partially written or stale entry is just a miss
+        return None
+
+def store(k, ret_type_id, library):
+    """
+    Stores a serialized library for the key ``k``. Failures to write are
+    ignored, since the cache is only an optimization.
+    """
+    path = cache_dir()
+    if k is None or path is None:
+        return
+    try:
+        if not os.path.isdir(path):
+            os.makedirs(path)
+        # Write to a temporary file and rename it into place, so concurrent
+        # processes never read a partial entry
+        fd, tmp = tempfile.mkstemp(dir=path, suffix='.tmp')
+        with os.fdopen(fd, 'wb') as f:
+            pickle.dump((int(ret_type_id), library), f,
+                        pickle.HIGHEST_PROTOCOL)
+        if os.name == 'nt' and os.path.exists(_path(k)):
+            os.remove(_path(k))
+        os.rename(tmp, _path(k))
+    except (IOError, OSError):
+        pass
+
+def clear():
+    """
+    Removes all entries from the cache directory.
+    """
+    path = cache_dir()
+    if path is None or not os.path.isdir(path):
+        return
+    for name in os.listdir(path):
+        if name.endswith(_SUFFIX):
+            try:
+                os.remove(os.path.join(path, name))
+            except OSError:
+                pass
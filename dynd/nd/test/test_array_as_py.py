@@ -47,5 +47,47 @@ class TestArrayAsPy(unittest.TestCase):
         a = nd.array(data, type=tp)
         self.assertEqual(nd.as_py(a), data)
 
+    def test_numeric(self):
+        for tp, vals in [('bool', [True, False, True]),
+                         ('int8', [-128, -6, 0, 127]),
+                         ('uint8', [0, 200, 255]),
+                         ('int16', [-30000, 5]),
+                         ('int32', [-2 ** 31, 2 ** 31 - 1]),
+                         ('int64', [-2 ** 63, 2 ** 63 - 1]),
+                         ('uint32', [2 ** 32 - 1]),
+                         ('uint64', [2 ** 64 - 1]),
+                         ('float32', [1.5, -0.25]),
+                         ('float64', [1e300, -2.5]),
+                         ('complex128', [1 + 2j, -3j])]:
+            a = nd.array(vals, type='%d * %s' % (len(vals), tp))
+            b = nd.as_py(a)
+            self.assertEqual(b, vals)
+            self.assertEqual([isinstance(x, (bool, float, complex)) and type(x)
+                              for x in b],
+                             [isinstance(x, (bool, float, complex)) and type(x)
+                              for x in vals])
+
+    def test_numeric_strided(self):
+        a = nd.array([[1, 2, 3], [4, 5, 6]], type='2 * 3 * int32')
+        self.assertEqual(nd.as_py(a), [[1, 2, 3], [4, 5, 6]])
+        self.assertEqual(nd.as_py(a[:, ::2]), [[1, 3], [4, 6]])
+        self.assertEqual(nd.as_py(a[:, 1]), [2, 5])
+        self.assertEqual(nd.as_py(nd.array([], type='0 * float64')), [])
+
+    def test_intern(self):
+        for tp in ['int16', 'uint16', 'int32', 'int64', 'float32', 'float64']:
+            a = nd.array([1000, 2000, 1000, 2000] * 3, type='12 * %s' % tp)
+            b = nd.as_py(a, intern=True)
+            self.assertEqual(b, nd.as_py(a))
+            self.assertTrue(b[0] is b[2] is b[10])
+            self.assertTrue(b[1] is b[3])
+            self.assertFalse(b[0] is b[1])
+
+        a = nd.array([[0.5, -0.0], [0.0, 0.5]], type='2 * 2 * float64')
+        b = nd.as_py(a, intern=True)
+        self.assertTrue(b[0][0] is b[1][1])
+        # Negative zero is a distinct value
+        self.assertFalse(b[0][1] is b[1][0])
+
 if __name__ == '__main__':
     unittest.main(verbosity=2)
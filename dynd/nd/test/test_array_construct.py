@@ -1,4 +1,5 @@
 import sys
+import array
 import unittest
 from datetime import date
 from dynd import nd, ndt
@@ -194,6 +195,32 @@ class TestViewConstructor(unittest.TestCase):
         # Can't construct a view of a python list
         self.assertRaises(TypeError, nd.view, [1, 2, 3])
 
+    def test_buffer_protocol(self):
+        # array.array exports a PEP 3118 buffer, which is viewed directly
+        a = array.array('d', [1.5, 2.5, 3.5])
+        b = nd.view(a)
+        self.assertEqual(nd.type_of(b), ndt.type('3 * float64'))
+        a[1] = 10
+        self.assertEqual(nd.as_py(b), [1.5, 10, 3.5])
+        b[2] = 20
+        self.assertEqual(a[2], 20)
+
+    @unittest.skipIf(sys.version_info < (3, 3), 'memoryview.cast requires Python 3.3')
+    def test_buffer_protocol_multidim(self):
+        a = array.array('i', range(6))
+        b = nd.view(memoryview(a).cast('B').cast('i', [2, 3]))
+        self.assertEqual(nd.type_of(b), ndt.type('2 * 3 * int32'))
+        self.assertEqual(nd.as_py(b), [[0, 1, 2], [3, 4, 5]])
+        # A strided slice of a memoryview keeps its strides
+        b = nd.view(memoryview(a)[::2])
+        self.assertEqual(nd.as_py(b), [0, 2, 4])
+
+    def test_buffer_protocol_readonly(self):
+        b = nd.view(memoryview(b'abc'))
+        self.assertEqual(nd.type_of(b), ndt.type('3 * uint8'))
+        self.assertEqual(b.access_flags, 'readonly')
+        self.assertEqual(nd.as_py(b), [97, 98, 99])
+
 class TestAsArrayConstructor(unittest.TestCase):
     # Constructs a view if possible, otherwise a copy
     def test_simple(self):
@@ -351,9 +378,47 @@ class TestStructConstruct(unittest.TestCase):
         self.assertEqual(nd.as_py(a.size.name), [['X'], ['L', 'M']])
         self.assertEqual(nd.as_py(a.size.id), [[10], [7, 5]])
 
+    def test_many_dicts(self):
+        # Enough rows for several blocks, with keys in varying orders, new
+        # key objects, and rows which aren't dicts mixed in
+        vals = []
+        for i in range(1000):
+            if i % 7 == 0:
+                vals.append((i, str(i)))
+            elif i % 3 == 0:
+                vals.append({'name': str(i), 'id': i})
+            else:
+                vals.append(dict([(''.join(['i', 'd']), i), ('name', str(i))]))
+        a = nd.array(vals, type='1000 * {id:int64, name:string}')
+        self.assertEqual(nd.as_py(a.id), list(range(1000)))
+        self.assertEqual(nd.as_py(a.name), [str(i) for i in range(1000)])
+
+    def test_columnar(self):
+        vals = [{'a': i, 'b': i * 0.5, 'c': str(i)} for i in range(10)]
+        a = nd.array(vals, type='10 * {a: int32, b: float64, c: string}',
+                     layout='columnar')
+        self.assertEqual(nd.type_of(a),
+                         ndt.type('{a: 10 * int32, b: 10 * float64, c: 10 * string}'))
+        self.assertEqual(nd.as_py(a.a), list(range(10)))
+        self.assertEqual(nd.as_py(nd.fields(a, 'b').b), [i * 0.5 for i in range(10)])
+        self.assertEqual(nd.as_py(a.c), [str(i) for i in range(10)])
+        # Each column is a contiguous view
+        import numpy as np
+        self.assertEqual(np.asarray(a.b).strides, (8,))
+        self.assertEqual(np.asarray(a.a).strides, (4,))
+
+    def test_columnar_errors(self):
+        self.assertRaises(TypeError, nd.array, [1, 2], layout='columnar')
+        self.assertRaises(TypeError, nd.array, [[(1, 2)], []],
+                          type='2 * var * {x: int32, y: int32}', layout='columnar')
+        self.assertRaises(ValueError, nd.array, [1], layout='rows')
+
     def test_missing_field(self):
         self.assertRaises(nd.BroadcastError, nd.array,
                         [0, 1], type='{x:int32, y:int32, z:int32}')
+        self.assertRaises(nd.BroadcastError, nd.array,
+                        [{'x':0, 'y':1, 'z':2}] * 300 + [{'x':0, 'z':1}],
+                        type='301 * {x:int32, y:int32, z:int32}')
         self.assertRaises(nd.BroadcastError, nd.array,
                         {'x':0, 'z':1}, type='{x:int32, y:int32, z:int32}')
 
@@ -695,6 +760,28 @@ class TestDeduceDims(unittest.TestCase):
 #        # Trigger failure in later type promotion
 #        self.assertRaises(ValueError, nd.array, [['a'], {'x' : 1}])
 
+class TestNumericListConstruct(unittest.TestCase):
+    def test_homogeneous(self):
+        a = nd.array([1, 2, 3, 4], type='4 * int16')
+        self.assertEqual(nd.as_py(a), [1, 2, 3, 4])
+        a = nd.array([1, 2, 3, 4], type='4 * uint64')
+        self.assertEqual(nd.as_py(a), [1, 2, 3, 4])
+        a = nd.array([1.5, 2.5, 3.5], type='3 * float64')
+        self.assertEqual(nd.as_py(a), [1.5, 2.5, 3.5])
+        a = nd.array([1.5j, 2.5, 3], type='3 * complex[float64]')
+        self.assertEqual(nd.as_py(a), [1.5j, 2.5, 3])
+
+    def test_mixed_runs(self):
+        # Runs of ints and floats mixed with big ints and other objects
+        a = nd.array([1, 2, 2.5, 3.5, 4, 2**40, nd.array(7)], type='7 * float64')
+        self.assertEqual(nd.as_py(a), [1, 2, 2.5, 3.5, 4, 2**40, 7])
+        a = nd.array([1, 2**40, 3, nd.array(4)], type='4 * int64')
+        self.assertEqual(nd.as_py(a), [1, 2**40, 3, 4])
+
+    def test_unsigned_overflow(self):
+        self.assertRaises(OverflowError, nd.array, [1, 2, -3], type='3 * uint32')
+        self.assertRaises(OverflowError, nd.array, [1, 2, 256], type='3 * uint8')
+
 class TestOptionArrayConstruct(unittest.TestCase):
     def check_scalars(self, type, input_expected):
         type = ndt.type(type)
@@ -65,5 +65,38 @@ class TestArrayGetItem(unittest.TestCase):
         self.assertEqual(nd.as_py(a[a[0] + 1]), 1)
 
 
+class TestArrayGetItemIndexArray(unittest.TestCase):
+    def test_int_indices(self):
+        a = nd.array([10, 11, 12, 13, 14, 15], type='6 * int32')
+        self.assertEqual(nd.as_py(a[[0, 2, 4]]), [10, 12, 14])
+        self.assertEqual(nd.as_py(a[[5, -1, 0, 0]]), [15, 15, 10, 10])
+        self.assertEqual(nd.as_py(a[nd.array([1, 2, 3], type='3 * int64')]), [11, 12, 13])
+        self.assertEqual(nd.type_of(a[[1, 2]]), ndt.type('2 * int32'))
+
+    def test_int_indices_multidim(self):
+        a = nd.array([[1, 2], [3, 4], [5, 6]], type='3 * 2 * float64')
+        self.assertEqual(nd.as_py(a[[2, 0]]), [[5, 6], [1, 2]])
+        # Rows which aren't contiguous
+        self.assertEqual(nd.as_py(a[:, 1][[2, 1]]), [6, 4])
+
+    def test_int_indices_strings(self):
+        a = nd.array([u'a', u'bc', u'def'], type='3 * string')
+        self.assertEqual(nd.as_py(a[[2, 2, 0]]), [u'def', u'def', u'a'])
+
+    def test_out_of_bounds(self):
+        a = nd.array([1, 2, 3])
+        self.assertRaises(IndexError, lambda x : x[[0, 3]], a)
+        self.assertRaises(IndexError, lambda x : x[[-4]], a)
+
+    def test_bool_mask(self):
+        a = nd.array([1, 2, 3, 4, 5], type='5 * int16')
+        self.assertEqual(nd.as_py(a[[True, False, True, True, False]]), [1, 3, 4])
+        self.assertEqual(nd.as_py(a[[False] * 5]), [])
+        self.assertRaises(IndexError, lambda x : x[[True, False]], a)
+
+    def test_bool_mask_struct(self):
+        a = nd.array([[1, u'a'], [2, u'b'], [3, u'c']], type='3 * {x: int32, y: string}')
+        self.assertEqual(nd.as_py(a[[False, True, True]]), nd.as_py(a[1:]))
+
 if __name__ == '__main__':
     unittest.main(verbosity=2)
@@ -42,5 +42,32 @@ class TestArraySetItem(unittest.TestCase):
         self.assertEqual(nd.as_py(a, tuple=True), value)
     """
 
+class TestArraySetItemIndexArray(unittest.TestCase):
+    def test_int_indices(self):
+        a = nd.array([0, 0, 0, 0, 0], type='5 * int32')
+        a[[0, 3, 4]] = [7, 8, 9]
+        self.assertEqual(nd.as_py(a), [7, 0, 0, 8, 9])
+
+    def test_int_indices_repeated(self):
+        # The last value for a repeated index wins
+        a = nd.array([0, 0, 0], type='3 * int64')
+        a[nd.array([1, 1], type='2 * int64')] = nd.array([5, 6], type='2 * int64')
+        self.assertEqual(nd.as_py(a), [0, 6, 0])
+
+    def test_broadcast(self):
+        a = nd.array([[0, 0], [0, 0], [0, 0]], type='3 * 2 * float64')
+        a[[0, 2]] = [1.5, 2.5]
+        self.assertEqual(nd.as_py(a), [[1.5, 2.5], [0, 0], [1.5, 2.5]])
+
+    def test_bool_mask(self):
+        a = nd.array([1, 2, 3, 4], type='4 * int32')
+        a[[True, False, False, True]] = 0
+        self.assertEqual(nd.as_py(a), [0, 2, 3, 0])
+
+    def test_strings(self):
+        a = nd.array([u'a', u'b', u'c'], type='3 * string')
+        a[[2, 0]] = [u'x', u'y']
+        self.assertEqual(nd.as_py(a), [u'y', u'b', u'x'])
+
 if __name__ == '__main__':
     unittest.main(verbosity=2)
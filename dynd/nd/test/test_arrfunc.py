@@ -254,6 +254,27 @@ class TestRollingArrFunc(unittest.TestCase):
         self.assertEqual(result[3:-1], [9.0/4, 14.0/4, 12.0/3])
     """
 
+class TestCallableGIL(unittest.TestCase):
+    def test_release_gil(self):
+        a = nd.array([1, 2, 3])
+        b = nd.array([4, 5, 6])
+        self.assertEqual(nd.as_py(nd.add(a, b)), [5, 7, 9])
+        # Opting out keeps the GIL held, with the same result
+        self.assertEqual(nd.as_py(nd.add(a, b, release_gil=False)), [5, 7, 9])
+
+    def test_concurrent_calls(self):
+        import threading
+        a = nd.array(list(range(100000)))
+        results = [None] * 4
+        def work(i):
+            results[i] = nd.as_py(nd.add(a, a))[-1]
+        threads = [threading.Thread(target=work, args=(i,)) for i in range(4)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertEqual(results, [199998] * 4)
+
 
 #class TestInlineArrfunc(unittest.TestCase):
 #   Todo: There is no skipIf for Python 2.6
@@ -0,0 +1,90 @@
+import sys
+import unittest
+from dynd import nd, ndt
+
+try:
+    import pyarrow as pa
+except ImportError:
+    pa = None
+
+class TestArrowRoundTrip(unittest.TestCase):
+    def roundtrip(self, a):
+        return nd.array.from_arrow(a.__arrow_c_array__())
+
+    def test_primitive(self):
+        a = nd.array([1, 2, 3], type='3 * int32')
+        b = self.roundtrip(a)
+        self.assertEqual(nd.type_of(b), ndt.type('3 * int32'))
+        self.assertEqual(nd.as_py(b), [1, 2, 3])
+
+    def test_primitive_strided(self):
+        a = nd.array([[1.5, 2.5], [3.5, 4.5], [5.5, 6.5]], type='3 * 2 * float64')
+        b = self.roundtrip(a[:, 1])
+        self.assertEqual(nd.as_py(b), [2.5, 4.5, 6.5])
+
+    def test_bool(self):
+        a = nd.array([True, False, True, True, False, False, True, False, True])
+        self.assertEqual(nd.as_py(self.roundtrip(a)), nd.as_py(a))
+
+    def test_option(self):
+        a = nd.array([1, None, 3], type='3 * ?int32')
+        b = self.roundtrip(a)
+        self.assertEqual(nd.type_of(b), ndt.type('3 * ?int32'))
+        self.assertEqual(nd.as_py(b), [1, None, 3])
+
+    def test_string(self):
+        a = nd.array([u'abc', u'', u'\u00e9f'], type='3 * string')
+        b = self.roundtrip(a)
+        self.assertEqual(nd.type_of(b), ndt.type('3 * string'))
+        self.assertEqual(nd.as_py(b), [u'abc', u'', u'\u00e9f'])
+
+    def test_struct(self):
+        a = nd.array([[1, u'a'], [2, u'bc']], type='2 * {x: int32, y: string}')
+        b = self.roundtrip(a)
+        self.assertEqual(nd.type_of(b), ndt.type('2 * {x: int32, y: string}'))
+        self.assertEqual(nd.as_py(b), nd.as_py(a))
+
+    def test_var_dim(self):
+        a = nd.array([[1, 2], [], [3]], type='3 * var * int32')
+        b = self.roundtrip(a)
+        self.assertEqual(nd.type_of(b), ndt.type('3 * var * int32'))
+        self.assertEqual(nd.as_py(b), [[1, 2], [], [3]])
+
+    def test_fixed_dim(self):
+        a = nd.array([[1, 2], [3, 4], [5, 6]], type='3 * 2 * int16')
+        b = self.roundtrip(a)
+        self.assertEqual(nd.type_of(b), ndt.type('3 * 2 * int16'))
+        self.assertEqual(nd.as_py(b), [[1, 2], [3, 4], [5, 6]])
+
+    def test_scalar_not_exportable(self):
+        self.assertRaises(TypeError, nd.array(1).__arrow_c_array__)
+
+    def test_released_capsule(self):
+        capsules = nd.array([1, 2, 3]).__arrow_c_array__()
+        nd.array.from_arrow(capsules)
+        # The first import moved the array out of the capsule
+        self.assertRaises(ValueError, nd.array.from_arrow, capsules)
+
+@unittest.skipIf(pa is None or not hasattr(pa.Array, '_import_from_c_capsule'),
+                 'pyarrow with the PyCapsule interface is not available')
+class TestPyArrowInterop(unittest.TestCase):
+    def test_from_pyarrow(self):
+        b = nd.array.from_arrow(pa.array([1, None, 3], type=pa.int64()))
+        self.assertEqual(nd.type_of(b), ndt.type('3 * ?int64'))
+        self.assertEqual(nd.as_py(b), [1, None, 3])
+
+    def test_from_pyarrow_sliced(self):
+        b = nd.array.from_arrow(pa.array([u'a', u'bc', u'def', u'g']).slice(1, 2))
+        self.assertEqual(nd.as_py(b), [u'bc', u'def'])
+
+    def test_to_pyarrow(self):
+        a = nd.array([[1.5, 2.5], [], [3.5]], type='3 * var * float64')
+        self.assertEqual(pa.array(a).to_pylist(), [[1.5, 2.5], [], [3.5]])
+
+    def test_to_pyarrow_struct(self):
+        a = nd.array([[1, u'a'], [2, u'bc']], type='2 * {x: int32, y: string}')
+        self.assertEqual(pa.array(a).to_pylist(),
+                         [{'x': 1, 'y': u'a'}, {'x': 2, 'y': u'bc'}])
+
+if __name__ == '__main__':
+    unittest.main(verbosity=2)
@@ -1,3 +1,5 @@
+import os
+import signal
 import sys
 if sys.version_info >= (2, 7):
     import unittest
@@ -33,27 +35,150 @@ class TestApply(unittest.TestCase):
         self.assertEqual(0, f(0))
         self.assertEqual(1, f(1))
 
+class JitCacheDirTestCase(unittest.TestCase):
     """
-    def test_numba(self):
+    Points the JIT cache at a temporary directory for each test.
+    """
+    def setUp(self):
+        import tempfile
+        self.old_dir = os.environ.get('DYND_JIT_CACHE_DIR')
+        self.dir = tempfile.mkdtemp()
+        os.environ['DYND_JIT_CACHE_DIR'] = self.dir
+
+    def tearDown(self):
+        import shutil
+        if self.old_dir is None:
+            del os.environ['DYND_JIT_CACHE_DIR']
+        else:
+            os.environ['DYND_JIT_CACHE_DIR'] = self.old_dir
+        shutil.rmtree(self.dir)
+
+class TestJitCache(JitCacheDirTestCase):
+    def test_store_load(self):
+        from dynd.nd import jit_cache
+        self.assertEqual(jit_cache.load('abc'), None)
+        jit_cache.store('abc', 12, b'library')
+        self.assertEqual(jit_cache.load('abc'), (12, b'library'))
+        jit_cache.clear()
+        self.assertEqual(jit_cache.load('abc'), None)
+
+    def test_key(self):
         try:
             import numba
         except ImportError as error:
             raise unittest.SkipTest(error)
+        from dynd.nd import jit_cache
 
-        @nd.functional.apply(jit = True)
         def f(x):
-            return x
+            return x + 1
 
-        self.assertEqual(f.type, ndt.callable(ndt.scalar, ndt.scalar))
-        self.assertEqual(0, f(0))
+        def g(x):
+            return x + 2
 
-        @nd.functional.apply(jit = True)
-        def f(x):
-            return x
+        self.assertEqual(jit_cache.key(f, [4]), jit_cache.key(f, [4]))
+        self.assertNotEqual(jit_cache.key(f, [4]), jit_cache.key(f, [5]))
+        self.assertNotEqual(jit_cache.key(f, [4]), jit_cache.key(g, [4]))
 
-        self.assertEqual(f.type, ndt.callable(ndt.scalar, ndt.scalar))
-        self.assertEqual(0, f(0))
-    """
+    def test_key_values(self):
+        try:
+            import numba
+        except ImportError as error:
+            raise unittest.SkipTest(error)
+        from dynd.nd import jit_cache
+        global _jit_offset
+
+        def adder(n):
+            def f(x):
+                return x + n
+            return f
+
+        # Numba freezes closure cells and globals into the compiled code
+        self.assertEqual(jit_cache.key(adder(1), [4]), jit_cache.key(adder(1), [4]))
+        self.assertNotEqual(jit_cache.key(adder(1), [4]), jit_cache.key(adder(2), [4]))
+
+        _jit_offset = 1
+        k = jit_cache.key(_add_jit_offset, [4])
+        _jit_offset = 2
+        self.assertNotEqual(jit_cache.key(_add_jit_offset, [4]), k)
+
+        obj = object()
+
+        def h(x):
+            return obj
+        self.assertEqual(jit_cache.key(h, [4]), None)
+
+    def test_warm_start(self):
+        try:
+            import numba
+            from llvmlite import ir
+            import ctypes
+        except ImportError as error:
+            raise unittest.SkipTest(error)
+        from dynd.nd import jit_cache
+
+        # Store compiled code the way a first run does, then load it back
+        codegen = nd.functional._numba_target_context().codegen()
+        library = codegen.create_library(name = 'library')
+        ir_module = library.create_ir_module(name = 'module')
+        single = ir.Function(ir_module, ir.FunctionType(ir.IntType(64), []),
+                             name = 'single')
+        ir.IRBuilder(single.append_basic_block('entry')).ret(
+            ir.Constant(ir.IntType(64), 42))
+        library.add_ir_module(ir_module)
+        library.finalize()
+        jit_cache.store('warm', 7, library.serialize_using_object_code())
+
+        cached = nd.functional._load_cached_jit('warm')
+        self.assertNotEqual(cached, None)
+        self.assertEqual(cached[0], 7)
+        f = ctypes.CFUNCTYPE(ctypes.c_int64)(
+            cached[1].get_pointer_to_function('single'))
+        self.assertEqual(f(), 42)
+
+        self.assertEqual(nd.functional._load_cached_jit('cold'), None)
+
+_jit_offset = 1
+
+def _add_jit_offset(x):
+    return x + _jit_offset
+
+def _jit_double(x):
+    return 2 * x
+
+class TestApplyJit(JitCacheDirTestCase):
+    def test_compile_and_reload(self):
+        try:
+            import numba
+        except ImportError as error:
+            raise unittest.SkipTest(error)
+        from dynd.nd import jit_cache
+
+        stores = []
+        store = jit_cache.store
+        def counting_store(*args):
+            stores.append(args[0])
+            store(*args)
+        jit_cache.store = counting_store
+        try:
+            # The first call compiles the int64 specialization and stores it
+            f = nd.functional.apply(_jit_double, jit = True)
+            self.assertEqual(nd.as_py(f(nd.array(21))), 42)
+            self.assertEqual(len(stores), 1)
+            self.assertNotEqual(jit_cache.load(stores[0]), None)
+
+            # A new callable, as in a new process, loads it back instead
+            g = nd.functional.apply(_jit_double, jit = True)
+            self.assertEqual(nd.as_py(g(nd.array(-4))), -8)
+            self.assertEqual(len(stores), 1)
+
+            # Once the cache is cleared, it is compiled again
+            jit_cache.clear()
+            h = nd.functional.apply(_jit_double, jit = True)
+            self.assertEqual(nd.as_py(h(nd.array(5))), 10)
+            self.assertEqual(len(stores), 2)
+            self.assertEqual(stores[1], stores[0])
+        finally:
+            jit_cache.store = store
 
 @unittest.skip('Test disabled since callables were reworked')
 class TestElwise(unittest.TestCase):
@@ -65,6 +190,91 @@ class TestElwise(unittest.TestCase):
 
 #        self.assertEqual(nd.array([2, 4, 6]), f([1, 2, 3]))
 
+class TestApplyBatch(unittest.TestCase):
+    def test_batch(self):
+        counts = []
+
+        @nd.functional.elwise
+        @nd.functional.apply(jit = False, batch = True)
+        @annotate(ndt.int32, ndt.int32)
+        def f(x):
+            # x holds a whole run of elements, not a single one
+            counts.append(len(x))
+            return [2 * v for v in nd.as_py(x)]
+
+        a = nd.array(list(range(1000)), type = '1000 * int32')
+        self.assertEqual(nd.as_py(f(a)), [2 * x for x in range(1000)])
+        self.assertEqual(sum(counts), 1000)
+        self.assertLess(len(counts), 1000)
+
+    def test_scalar_result(self):
+        @nd.functional.elwise
+        @nd.functional.apply(jit = False, batch = True)
+        @annotate(ndt.int32, ndt.int32)
+        def f(x):
+            # A scalar is broadcast over the run
+            return 7
+
+        a = nd.array(list(range(100)), type = '100 * int32')
+        self.assertEqual(nd.as_py(f(a)), [7] * 100)
+
+    def test_type(self):
+        @annotate(ndt.float64, ndt.int32)
+        def f(x, y):
+            z = x
+            return z
+
+        # Only the arguments, not the other locals, are in the type
+        self.assertEqual(nd.functional._annotated_type(f),
+                         ndt.type('(int32, Scalar) -> float64'))
+
+class TestParallelElwise(unittest.TestCase):
+    def test_threads(self):
+        f = nd.functional.elwise(nd.add, nthreads = 4, grain = 16)
+        a = nd.array(list(range(1000)), type = '1000 * int64')
+
+        before = nd.functional.thread_pool_stats()
+        self.assertEqual(nd.as_py(f(a, a)), [2 * x for x in range(1000)])
+        after = nd.functional.thread_pool_stats()
+        # One loop, split into ceil(1000 / 16) chunks
+        self.assertEqual(after['loops'] - before['loops'], 1)
+        self.assertEqual(after['chunks'] - before['chunks'], 63)
+
+        # Arguments without a shared outer dimension run on one thread
+        self.assertEqual(nd.as_py(f(3, 4)), 7)
+        self.assertEqual(nd.functional.thread_pool_stats(), after)
+
+    def test_default_grain(self):
+        f = nd.functional.elwise(nd.add, nthreads = 4)
+        a = nd.array(list(range(1000)), type = '1000 * int64')
+
+        before = nd.functional.thread_pool_stats()
+        self.assertEqual(nd.as_py(f(a, a)), [2 * x for x in range(1000)])
+        after = nd.functional.thread_pool_stats()
+        # A few chunks for each thread
+        self.assertEqual(after['chunks'] - before['chunks'], 16)
+
+    @unittest.skipIf(not hasattr(os, 'fork'), 'fork is not available')
+    def test_fork(self):
+        f = nd.functional.elwise(nd.add, nthreads = 4, grain = 16)
+        a = nd.array(list(range(1000)), type = '1000 * int64')
+        expected = [2 * x for x in range(1000)]
+        # Start the pool's workers in this process first
+        f(a, a)
+        pid = os.fork()
+        if pid == 0:
+            # The child has none of the workers, and must not wait for them
+            signal.alarm(30)
+            try:
+                ok = nd.as_py(f(a, a)) == expected
+                # The child's own pool ran the loop on several threads
+                ok = ok and nd.functional.thread_pool_stats()['loops'] == 1
+                os._exit(0 if ok else 1)
+            except BaseException:
+                os._exit(1)
+        _, status = os.waitpid(pid, 0)
+        self.assertEqual(status, 0)
+
 @unittest.skip('Test disabled since callables were reworked')
 class TestReduction(unittest.TestCase):
     def test_unary(self):
@@ -76,18 +286,165 @@ class TestReduction(unittest.TestCase):
         self.assertEqual(3, f([1, 2, 3]))
         self.assertEqual(6, f([[1, 2, 3], [4, 5, 6]]))
 
-"""
-def multigen(func):
-    return lambda x: x
+class TestParallelReduction(unittest.TestCase):
+    def test_sum(self):
+        f = nd.functional.parallel_reduction(nd.sum, nthreads = 4, grain = 100)
+        a = nd.array(list(range(10007)), type = '10007 * int64')
+        self.assertEqual(nd.as_py(f(a)), sum(range(10007)))
+        b = nd.array([[i, -2 * i, 3] for i in range(1001)], type = '1001 * 3 * int64')
+        self.assertEqual(nd.as_py(f(b)), -sum(range(1001)) + 3 * 1001)
+
+    def test_float_sum(self):
+        import math
+        values = [0.1] * 100000
+        f = nd.functional.parallel_reduction(nd.sum, nthreads = 4, grain = 1000)
+        exact = math.fsum(values)
+        # Summing the blocks separately loses less to rounding
+        self.assertLessEqual(abs(nd.as_py(f(nd.array(values))) - exact),
+                             abs(nd.as_py(nd.sum(nd.array(values))) - exact))
+
+    def test_passthrough(self):
+        f = nd.functional.parallel_reduction(nd.sum, nthreads = 4)
+        self.assertEqual(nd.as_py(f(nd.array([5]))), 5)
+        a = nd.array([[1, 2], [3, 4], [5, 6]], type = '3 * 2 * int32')
+        self.assertEqual(nd.as_py(f(a, axes = [0])), [9, 12])
+
+    def test_errors(self):
+        self.assertRaises(ValueError, nd.functional.parallel_reduction,
+                          nd.sum, grain = -1)
+
+class TestFromUfunc(unittest.TestCase):
+    def test_binary(self):
+        import numpy as np
+        add = nd.functional.from_ufunc(np.add)
+        self.assertEqual(nd.as_py(add(nd.array([1.5, 2.5]), nd.array([1.0, 2.0]))),
+                         [2.5, 4.5])
+        a = nd.array([1, 2, 3], type = '3 * int32')
+        b = add(a, a)
+        self.assertEqual(nd.type_of(b), ndt.type('3 * int32'))
+        self.assertEqual(nd.as_py(b), [2, 4, 6])
 
-class TestMultidispatch(unittest.TestCase):
     def test_unary(self):
-        @nd.functional.multidispatch()
-        def callables():
-            yield 5
+        import numpy as np
+        sqrt = nd.functional.from_ufunc(np.sqrt)
+        self.assertEqual(nd.as_py(sqrt(nd.array([[1.0, 4.0], [9.0, 16.0]]))),
+                         [[1.0, 2.0], [3.0, 4.0]])
+
+    def test_comparison(self):
+        import numpy as np
+        less = nd.functional.from_ufunc(np.less)
+        b = less(nd.array([1.0, 2.0, 3.0]), nd.array([2.0, 2.0, 2.0]))
+        self.assertEqual(nd.type_of(b), ndt.type('3 * bool'))
+        self.assertEqual(nd.as_py(b), [True, False, False])
+
+    def test_mixed_types(self):
+        import numpy as np
+        ldexp = nd.functional.from_ufunc(np.ldexp)
+        b = ldexp(nd.array([1.0, 1.5, 3.0]), nd.array([1, 2, 3], type = '3 * int32'))
+        self.assertEqual(nd.type_of(b), ndt.type('3 * float64'))
+        self.assertEqual(nd.as_py(b), [2.0, 6.0, 24.0])
+
+    def test_strided(self):
+        import numpy as np
+        multiply = nd.functional.from_ufunc(np.multiply)
+        a = nd.array([[float(i), -float(i)] for i in range(100)])
+        self.assertEqual(nd.as_py(multiply(a[:, 0], a[:, 1])),
+                         [-float(i * i) for i in range(100)])
+        # More elements than one buffer holds, ending in a partial buffer
+        a = nd.array([[float(i), 2.0] for i in range(1300)])
+        self.assertEqual(nd.as_py(multiply(a[:, 0], a[:, 1])),
+                         [2.0 * i for i in range(1300)])
+
+    def test_errors(self):
+        import numpy as np
+        self.assertRaises(TypeError, nd.functional.from_ufunc, len)
+        # Only ufuncs with one output are supported
+        self.assertRaises(ValueError, nd.functional.from_ufunc, np.modf)
+
+class TestReduceChunks(unittest.TestCase):
+    def test_iterable(self):
+        chunks = (nd.array([float(i), i + 0.5, i + 0.25]) for i in range(10))
+        self.assertEqual(nd.as_py(nd.functional.reduce_chunks(nd.sum, chunks)),
+                         sum(3 * i + 0.75 for i in range(10)))
+
+    def test_array(self):
+        a = nd.array([[i, 2 * i] for i in range(100)], type='100 * 2 * int64')
+        self.assertEqual(nd.as_py(nd.functional.reduce_chunks(nd.sum, a,
+                                                              chunk_rows=7)),
+                         3 * sum(range(100)))
+        self.assertEqual(nd.as_py(nd.functional.reduce_chunks(nd.sum, a,
+                         axes=[0], chunk_rows=7)),
+                         [sum(range(100)), 2 * sum(range(100))])
+
+    def test_inner_axis(self):
+        a = nd.array([[i, 2 * i] for i in range(10)], type='10 * 2 * int64')
+        self.assertEqual(nd.as_py(nd.functional.reduce_chunks(nd.sum, a,
+                         axes=[-1], chunk_rows=3)),
+                         [3 * i for i in range(10)])
+
+    def test_memmap(self):
+        import tempfile
+        fd, path = tempfile.mkstemp()
+        os.close(fd)
+        try:
+            a = nd.memmap(path, '1000 * int32', mode='w+')
+            a[...] = list(range(1000))
+            del a
+            a = nd.memmap(path)
+            self.assertEqual(nd.as_py(nd.functional.reduce_chunks(nd.sum, a,
+                             chunk_rows=64)), sum(range(1000)))
+            del a
+        finally:
+            os.remove(path)
+
+    def test_errors(self):
+        self.assertRaises(ValueError, nd.functional.reduce_chunks, nd.sum, [])
+        self.assertRaises(ValueError, nd.functional.reduce_chunks, nd.sum,
+                          nd.array([1, 2, 3]), chunk_rows=0)
+
+class TestMultidispatch(unittest.TestCase):
+    def test_dispatch(self):
+        f = nd.functional.multidispatch(ndt.type('(Scalar, Scalar) -> Scalar'),
+                                        [nd.add])
+        self.assertEqual(nd.as_py(f(1, 2)), 3)
+        self.assertEqual(nd.as_py(f(1.5, 2.0)), 3.5)
+
+    def test_cache(self):
+        f = nd.functional.multidispatch(ndt.type('(Scalar, Scalar) -> Scalar'),
+                                        [nd.add])
+        self.assertEqual(nd.functional.dispatch_stats(f),
+                         {'hits': 0, 'misses': 0, 'size': 0})
+        for i in range(10):
+            f(i, 1)
+        self.assertEqual(nd.functional.dispatch_stats(f),
+                         {'hits': 9, 'misses': 1, 'size': 1})
+        f(1.5, 1.5)
+        self.assertEqual(nd.functional.dispatch_stats(f),
+                         {'hits': 9, 'misses': 2, 'size': 2})
+        nd.functional.clear_dispatch_cache(f)
+        self.assertEqual(nd.functional.dispatch_stats(f),
+                         {'hits': 0, 'misses': 0, 'size': 0})
+
+    def test_order(self):
+        tp = ndt.type('(Scalar, Scalar) -> Scalar')
+        # Both match, and the first one listed wins
+        f = nd.functional.multidispatch(tp, [nd.add, nd.subtract])
+        self.assertEqual(nd.as_py(f(5, 3)), 8)
+        f = nd.functional.multidispatch(tp, [nd.subtract, nd.add])
+        self.assertEqual(nd.as_py(f(5, 3)), 2)
+
+    def test_sizes(self):
+        f = nd.functional.multidispatch(ndt.type('(Any, Any) -> Any'), [nd.add])
+        for n in range(1, 50):
+            a = nd.array(list(range(n)), type = '%d * int64' % n)
+            self.assertEqual(nd.as_py(f(a, a)), [2 * i for i in range(n)])
+        # Arrays of every length share one entry
+        self.assertEqual(nd.functional.dispatch_stats(f),
+                         {'hits': 48, 'misses': 1, 'size': 1})
 
-        print callables(3)
-"""
+    def test_not_dispatch(self):
+        self.assertRaises(TypeError, nd.functional.dispatch_stats, nd.add)
+        self.assertRaises(TypeError, nd.functional.clear_dispatch_cache, nd.add)
 
 if __name__ == '__main__':
     unittest.main(verbosity=2)
@@ -0,0 +1,74 @@
+import io
+import unittest
+from dynd import nd, ndt
+
+class TestParseJSONStream(unittest.TestCase):
+    def test_iterable(self):
+        # Blocks don't have to end at line boundaries
+        blocks = [b'{"x": 1, "y": "a"}\n{"x": 2,', b' "y": "b"}\n\n{"x": 3, "y": "c"}']
+        a = nd.parse_json_stream('{x: int32, y: string}', blocks)
+        self.assertEqual(nd.type_of(a), ndt.type('3 * {x: int32, y: string}'))
+        self.assertEqual(nd.as_py(a), [{'x': 1, 'y': 'a'}, {'x': 2, 'y': 'b'},
+                                       {'x': 3, 'y': 'c'}])
+
+    def test_file(self):
+        text = u''.join(u'[%d, %d]\n' % (i, 2 * i) for i in range(1000))
+        a = nd.parse_json_stream('2 * int64', io.StringIO(text), chunk_rows=64,
+                                 block_size=100)
+        self.assertEqual(nd.type_of(a), ndt.type('1000 * 2 * int64'))
+        self.assertEqual(nd.as_py(a), [[i, 2 * i] for i in range(1000)])
+
+    def test_batches(self):
+        lines = ['%d\n' % i for i in range(10)]
+        batches = list(nd.parse_json_stream('float64', lines, chunk_rows=4,
+                                            batches=True))
+        self.assertEqual([len(b) for b in batches], [4, 4, 2])
+        self.assertEqual(sum((nd.as_py(b) for b in batches), []),
+                         [float(i) for i in range(10)])
+
+    def test_empty(self):
+        a = nd.parse_json_stream('int32', [])
+        self.assertEqual(nd.type_of(a), ndt.type('0 * int32'))
+
+    def test_invalid(self):
+        self.assertRaises(Exception, nd.parse_json_stream, 'int32',
+                          ['1\n', '"a"\n'])
+
+    def test_discovered_type(self):
+        lines = [u'{"id": %d, "tag": %s}\n' % (i, u'null' if i % 3 else u'"t"')
+                 for i in range(10)]
+        a = nd.parse_json_stream(ndt.discover_json(lines), lines)
+        self.assertEqual(nd.type_of(a), ndt.type('10 * {id: int64, tag: ?string}'))
+        self.assertEqual(nd.as_py(a)[:2], [{'id': 0, 'tag': 't'},
+                                           {'id': 1, 'tag': None}])
+
+class TestParseJSONThreads(unittest.TestCase):
+    def test_var(self):
+        text = u''.join(u'{"x": %d, "y": "%d"}\n' % (i, i) for i in range(5000))
+        a = nd.parse_json('var * {x: int32, y: string}', text, nthreads=4)
+        self.assertEqual(nd.type_of(a), ndt.type('var * {x: int32, y: string}'))
+        self.assertEqual(nd.as_py(a), [{'x': i, 'y': str(i)} for i in range(5000)])
+
+    def test_fixed(self):
+        text = u''.join(u'[%d, 1.5]\n\n' % i for i in range(1000)).encode('utf-8')
+        a = nd.parse_json('1000 * 2 * float64', text, nthreads=3)
+        self.assertEqual(nd.as_py(a), [[float(i), 1.5] for i in range(1000)])
+
+    def test_var_records(self):
+        # Records with var dims are parsed serially, but give the same result
+        text = u''.join(u'[%s]\n' % u', '.join([u'1'] * (i % 5)) for i in range(100))
+        a = nd.parse_json('var * var * int8', text, nthreads=4)
+        self.assertEqual(nd.as_py(a), [[1] * (i % 5) for i in range(100)])
+
+    def test_into_array(self):
+        a = nd.empty('100 * int64')
+        nd.parse_json(a, u''.join(u'%d\n' % i for i in range(100)), nthreads=0)
+        self.assertEqual(nd.as_py(a), list(range(100)))
+
+    def test_wrong_count(self):
+        self.assertRaises(ValueError, nd.parse_json, '3 * int32', u'1\n2\n',
+                          nthreads=2)
+        self.assertRaises(TypeError, nd.parse_json, 'int32', u'1\n', nthreads=2)
+
+if __name__ == '__main__':
+    unittest.main(verbosity=2)
@@ -0,0 +1,58 @@
+import os
+import shutil
+import tempfile
+import unittest
+from dynd import nd, ndt
+
+class TestMemmap(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.mkdtemp()
+        self.path = os.path.join(self.dir, 'a.dynd')
+
+    def tearDown(self):
+        shutil.rmtree(self.dir)
+
+    def test_create_and_open(self):
+        a = nd.memmap(self.path, '3 * 4 * float64', 'w+')
+        self.assertEqual(nd.type_of(a), ndt.type('3 * 4 * float64'))
+        self.assertEqual(nd.as_py(a), [[0.0] * 4] * 3)
+        a[1] = [1, 2, 3, 4]
+        del a
+
+        b = nd.memmap(self.path)
+        self.assertEqual(nd.type_of(b), ndt.type('3 * 4 * float64'))
+        self.assertEqual(nd.as_py(b[1]), [1.0, 2.0, 3.0, 4.0])
+        self.assertEqual(b.access_flags, 'readonly')
+
+    def test_modes(self):
+        a = nd.memmap(self.path, '5 * int32', 'w+')
+        a[...] = [1, 2, 3, 4, 5]
+        del a
+
+        # Copy on write changes aren't written back
+        c = nd.memmap(self.path, mode='c')
+        c[0] = 100
+        self.assertEqual(nd.as_py(c), [100, 2, 3, 4, 5])
+        del c
+        self.assertEqual(nd.as_py(nd.memmap(self.path)), [1, 2, 3, 4, 5])
+
+        w = nd.memmap(self.path, '5 * int32', mode='r+')
+        w[4] = 50
+        del w
+        self.assertEqual(nd.as_py(nd.memmap(self.path)), [1, 2, 3, 4, 50])
+
+    def test_errors(self):
+        self.assertRaises(TypeError, nd.memmap, self.path, 'var * int32', 'w+')
+        self.assertRaises(TypeError, nd.memmap, self.path, '3 * string', 'w+')
+        self.assertRaises(ValueError, nd.memmap, self.path, '3 * int32', 'x')
+        self.assertRaises(OSError, nd.memmap, os.path.join(self.dir, 'missing'))
+
+        nd.memmap(self.path, '2 * int16', 'w+')
+        self.assertRaises(TypeError, nd.memmap, self.path, '2 * int32')
+
+        with open(self.path, 'wb') as f:
+            f.write(b'not an array')
+        self.assertRaises(ValueError, nd.memmap, self.path)
+
+if __name__ == '__main__':
+    unittest.main(verbosity=2)
@@ -629,6 +629,62 @@ class TestNumpyScalarInterop(unittest.TestCase):
                                             ('z', 'float64')], align=True))
         self.assertEqual(b.tolist(), [(1, "testing", 1.5), (10, "abc", 2)])
 
+class TestStringOffsets(unittest.TestCase):
+    def test_export(self):
+        offsets, data = nd.string_offsets(nd.array([u'abc', u'', u'\u00e9f']))
+        self.assertEqual(nd.type_of(offsets), ndt.type('4 * int32'))
+        assert_equal(np.asarray(offsets), [0, 3, 3, 6])
+        self.assertEqual(np.asarray(data).tobytes(), u'abc\u00e9f'.encode('utf-8'))
+
+    def test_export_large(self):
+        offsets, data = nd.string_offsets(nd.array([u'ab', u'c']), large=True)
+        self.assertEqual(nd.type_of(offsets), ndt.type('3 * int64'))
+        assert_equal(np.asarray(offsets), [0, 2, 3])
+
+    def test_export_not_strings(self):
+        self.assertRaises(TypeError, nd.string_offsets, nd.array([1, 2, 3]))
+
+    def test_roundtrip(self):
+        strings = [u'first', u'', u'\u4e2d\u6587', u'last']
+        offsets, data = nd.string_offsets(nd.array(strings))
+        a = nd.from_string_offsets(np.asarray(offsets), np.asarray(data))
+        self.assertEqual(nd.type_of(a), ndt.type('4 * string'))
+        self.assertEqual(nd.as_py(a), strings)
+
+    def test_import_invalid(self):
+        data = np.frombuffer(b'abc', dtype=np.uint8)
+        self.assertRaises(ValueError, nd.from_string_offsets,
+                          np.array([0, 2, 1], dtype=np.int32), data)
+        self.assertRaises(ValueError, nd.from_string_offsets,
+                          np.array([0, 4], dtype=np.int32), data)
+
+@unittest.skipIf(not hasattr(np, 'from_dlpack'), 'NumPy does not support DLPack')
+class TestDLPack(unittest.TestCase):
+    def test_from_numpy(self):
+        a = np.arange(12, dtype=np.float32).reshape(3, 4)[:, ::2]
+        b = nd.from_dlpack(a)
+        self.assertEqual(nd.type_of(b), ndt.type('3 * 2 * float32'))
+        assert_equal(nd.as_py(b), a.tolist())
+        # The data is shared, not copied
+        a[0, 0] = 100
+        self.assertEqual(nd.as_py(b[0, 0]), 100)
+
+    def test_to_numpy(self):
+        a = nd.array([[1, 2, 3], [4, 5, 6]], type='2 * 3 * int64')
+        b = np.from_dlpack(a)
+        self.assertEqual(b.dtype, np.int64)
+        assert_equal(b, [[1, 2, 3], [4, 5, 6]])
+
+    def test_complex(self):
+        a = nd.array([1 + 2j, 3 - 4j], type='2 * complex[float64]')
+        assert_equal(np.from_dlpack(a), [1 + 2j, 3 - 4j])
+
+    def test_device(self):
+        self.assertEqual(nd.array([1, 2]).__dlpack_device__(), (1, 0))
+
+    def test_unsupported(self):
+        self.assertRaises(TypeError, nd.array(['a', 'b']).__dlpack__)
+
 
 if __name__ == '__main__':
     unittest.main(verbosity=2)
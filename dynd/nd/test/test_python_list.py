@@ -54,6 +54,32 @@ class TestPythonList(unittest.TestCase):
         self.assertEqual(a.shape, (2,3))
         self.assertEqual(nd.as_py(a), lst)
 
+    def test_promotion(self):
+        # Later values widen the type of the ones already converted
+        lst = [True, 1, 20000000000, 2.5]
+        a = nd.array(lst[:2])
+        self.assertEqual(nd.dtype_of(a), ndt.int32)
+        self.assertEqual(nd.as_py(a), [1, 1])
+        a = nd.array(lst[:3])
+        self.assertEqual(nd.dtype_of(a), ndt.int64)
+        self.assertEqual(nd.as_py(a), [1, 1, 20000000000])
+        a = nd.array(lst)
+        self.assertEqual(nd.dtype_of(a), ndt.float64)
+        self.assertEqual(nd.as_py(a), [1.0, 1.0, 2e10, 2.5])
+
+        lst = [[1, 2], [3, 4.5], [5, 6]]
+        a = nd.array(lst)
+        self.assertEqual(nd.dtype_of(a), ndt.float64)
+        self.assertEqual(a.shape, (3,2))
+        self.assertEqual(nd.as_py(a), lst)
+
+    def test_ragged(self):
+        # Ragged lists go through the general conversion
+        lst = [[1, 2], [3, 4, 5.0]]
+        a = nd.array(lst)
+        self.assertEqual(nd.type_of(a), ndt.type('2 * var * float64'))
+        self.assertEqual(nd.as_py(a), lst)
+
     """
     def test_float64(self):
         lst = [0, 100.0, 1e25, -1000000000+3j]
@@ -61,5 +61,49 @@ class TestDType(unittest.TestCase):
         self.assertEqual(nd.as_py(colors.ints), color_vals_int)
 """
 
+class TestCategoricalCodes(unittest.TestCase):
+    def test_roundtrip(self):
+        import numpy as np
+        codes = np.array([2, 0, 1, 1, 2], dtype=np.int8)
+        a = nd.from_categorical_codes(codes, [u'low', u'mid', u'high'])
+        self.assertEqual(nd.as_py(a), [u'high', u'low', u'mid', u'mid', u'high'])
+
+        c, categories = nd.categorical_codes(a)
+        self.assertEqual(nd.type_of(c), ndt.type('5 * uint8'))
+        self.assertEqual(nd.as_py(c), [2, 0, 1, 1, 2])
+        self.assertEqual(nd.as_py(categories), [u'low', u'mid', u'high'])
+
+    def test_view(self):
+        import numpy as np
+        codes = np.array([1, 0, 1], dtype=np.uint8)
+        codes.setflags(write=False)
+        a = nd.from_categorical_codes(codes, [1.5, 2.5])
+        c, categories = nd.categorical_codes(a)
+        # Both directions share the codes' memory
+        self.assertEqual(np.asarray(c).ctypes.data, codes.ctypes.data)
+        self.assertEqual(nd.as_py(categories), [1.5, 2.5])
+        # Neither view can be used to write unchecked codes
+        self.assertFalse(np.asarray(c).flags.writeable)
+        def assign(x):
+            x[0] = 0
+        self.assertRaises(ValueError, assign, np.asarray(c))
+        self.assertRaises(Exception, assign, a)
+
+    def test_writable_codes(self):
+        import numpy as np
+        codes = np.array([1, 0, 1], dtype=np.uint8)
+        a = nd.from_categorical_codes(codes, [u'a', u'b'])
+        c, _ = nd.categorical_codes(a)
+        # Codes which can still change are copied, not viewed
+        self.assertNotEqual(np.asarray(c).ctypes.data, codes.ctypes.data)
+        codes[0] = 200
+        self.assertEqual(nd.as_py(a), [u'b', u'a', u'b'])
+
+    def test_out_of_range(self):
+        self.assertRaises(ValueError, nd.from_categorical_codes, [0, -1], [u'a'])
+        self.assertRaises(ValueError, nd.from_categorical_codes, [0, 2], [u'a', u'b'])
+        self.assertRaises(TypeError, nd.from_categorical_codes, [0.5], [u'a'])
+        self.assertRaises(TypeError, nd.categorical_codes, nd.array([1, 2]))
+
 if __name__ == '__main__':
     unittest.main(verbosity=2)
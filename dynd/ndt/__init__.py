@@ -11,3 +11,4 @@ from .dim_helpers import *
 from . import dynd_ctypes as ctypes
 
 from . import json
+from .json import discover_json
@@ -1,7 +1,165 @@
 # cython: c_string_type=str, c_string_encoding=ascii
 
+from __future__ import absolute_import
+
+import collections as _collections
+import itertools as _itertools
+import json as _json
+
 from ..cpp.json_parser cimport discover as _discover
-#from ..wrapper cimport wrap
+from .type import type as _type, make_struct, make_var_dim
+
+# The kinds of values seen while sampling. A kind is a tuple
+# (name, nullable, payload), where the payload is the element kind of a
+# list or an ordered dict of field kinds for an object. 'empty' is the kind
+# of a value nothing is known about yet, like the elements of an empty list.
+_EMPTY = ('empty', False, None)
+_NULL = ('empty', True, None)
+_NUMERIC = ('int', 'float')
+
+_INT64_MIN = -2 ** 63
+_INT64_MAX = 2 ** 63 - 1
+
+def _infer(obj):
+    if obj is None:
+        return _NULL
+    if isinstance(obj, bool):
+        return ('bool', False, None)
+    if isinstance(obj, float):
+        return ('float', False, None)
+    if isinstance(obj, (int, long)):
+        if _INT64_MIN <= obj <= _INT64_MAX:
+            return ('int', False, None)
+        return ('float', False, None)
+    if isinstance(obj, basestring):
+        return ('string', False, None)
+    if isinstance(obj, list):
+        elem = _EMPTY
+        for x in obj:
+            elem = _merge(elem, _infer(x))
+        return ('list', False, elem)
+    if isinstance(obj, dict):
+        return ('struct', False,
+                _collections.OrderedDict((k, _infer(v)) for k, v in obj.items()))
+    return ('json', False, None)
+
+def _merge(a, b):
+    nullable = a[1] or b[1]
+    if a[0] == 'empty':
+        return (b[0], nullable, b[2])
+    if b[0] == 'empty':
+        return (a[0], nullable, a[2])
+    if a[0] == b[0]:
+        if a[0] == 'list':
+            return ('list', nullable, _merge(a[2], b[2]))
+        if a[0] == 'struct':
+            fields = _collections.OrderedDict()
+            for name, kind in a[2].items():
+                if name in b[2]:
+                    fields[name] = _merge(kind, b[2][name])
+                else:
+                    # Missing from some records
+                    fields[name] = (kind[0], True, kind[2])
+            for name, kind in b[2].items():
+                if name not in a[2]:
+                    fields[name] = (kind[0], True, kind[2])
+            return ('struct', nullable, fields)
+        return (a[0], nullable, None)
+    if a[0] in _NUMERIC and b[0] in _NUMERIC:
+        return ('float', nullable, None)
+    # Anything else is kept as the raw JSON text
+    return ('json', nullable, None)
+
+def _make_type(kind):
+    name, nullable, payload = kind
+    if name == 'list':
+        # Dimensions can't be optional, so a list which is sometimes null
+        # keeps its var dimension
+        return make_var_dim(_make_type(payload))
+    if name == 'struct':
+        if nullable:
+            # A struct can't be missing, so an object which is sometimes
+            # null or absent keeps its raw JSON text
+            return _type('?json')
+        return make_struct([_make_type(k) for k in payload.values()],
+                           list(payload.keys()))
+    tp = _type({'empty': 'json', 'bool': 'bool', 'int': 'int64',
+               'float': 'float64', 'string': 'string', 'json': 'json'}[name])
+    if nullable:
+        tp = _type('?' + str(tp))
+    return tp
+
+def _sample_lines(data, sample_rows, strided):
+    if isinstance(data, bytes):
+        data = data.decode('utf-8')
+    if isinstance(data, basestring):
+        data = data.splitlines()
+    lines = (line for line in data if line.strip())
+    if not strided or sample_rows == 1:
+        return _itertools.islice(lines, sample_rows)
+
+    # Keep every step-th line in one pass over the data, doubling the step
+    # and dropping every other kept line whenever 2 * sample_rows of them
+    # pile up, so memory stays bounded however long the data is
+    step = 1
+    kept = []
+    count = 0
+    last = None
+    for i, line in enumerate(lines):
+        if i % step == 0:
+            kept.append(line)
+            if len(kept) == 2 * sample_rows:
+                del kept[1::2]
+                step *= 2
+        last = line
+        count = i + 1
+    if count > 0 and (count - 1) % step != 0:
+        kept.append(last)
+    if len(kept) <= sample_rows:
+        return kept
+
+    # Spread the picks so the first and the last lines are both sampled
+    end = len(kept) - 1
+    return [kept[i * end // (sample_rows - 1)] for i in range(sample_rows)]
+
+def discover_json(data, sample_rows=1000, strided=False):
+    """
+    ndt.discover_json(data, sample_rows=1000, strided=False)
+    Infers the type of the records in newline-delimited JSON from a sample
+    of them, for use with nd.parse_json_stream, or with nd.parse_json after
+    wrapping it in a var dimension.
+
+    Objects become structs, whose fields are the union of those seen, and
+    lists become var dimensions. A value which is null, or a field which is
+    missing from some records, becomes an option type. Integers and floats
+    seen for the same value widen to float64, and any other mix of kinds
+    falls back to the json type.
+
+    Parameters
+    ----------
+    data : string, bytes, file or iterable of lines
+        The newline-delimited JSON to sample.
+    sample_rows : int, optional
+        The maximum number of records to look at.
+    strided : bool, optional
+        If True, the sampled records are spread roughly evenly over all
+        of the records, including the last, rather than taken from the
+        start. This reads through all of the lines once, holding at most
+        2 * sample_rows of them, and only parses the sampled ones.
+
+    Examples
+    --------
+    >>> from dynd import nd, ndt
+    >>> ndt.discover_json('{"x": 1, "y": "a"}\\n{"x": 2.5}\\n')
+    ndt.type("{x : float64, y : ?string}")
+    """
+    if sample_rows <= 0:
+        raise ValueError('sample_rows must be positive, not %d' % sample_rows)
 
-#def discover(obj):
-#    return wrap(_discover(str(obj)))
+    kind = _EMPTY
+    for line in _sample_lines(data, sample_rows, strided):
+        if isinstance(line, bytes):
+            line = line.decode('utf-8')
+        kind = _merge(kind, _infer(
+            _json.loads(line, object_pairs_hook=_collections.OrderedDict)))
+    return _make_type(kind)
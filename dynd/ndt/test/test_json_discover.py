@@ -0,0 +1,56 @@
+import io
+import unittest
+from dynd import ndt
+
+class TestDiscoverJSON(unittest.TestCase):
+    def test_scalars(self):
+        self.assertEqual(ndt.discover_json(u'1\n2\n'), ndt.int64)
+        self.assertEqual(ndt.discover_json(u'true\n'), ndt.bool)
+        self.assertEqual(ndt.discover_json(u'"a"\n'), ndt.string)
+
+    def test_widen_numeric(self):
+        self.assertEqual(ndt.discover_json(u'1\n2.5\n3\n'), ndt.float64)
+        self.assertEqual(ndt.discover_json(u'%d\n' % 2 ** 70), ndt.float64)
+
+    def test_option(self):
+        self.assertEqual(ndt.discover_json(u'1\nnull\n'), ndt.type('?int64'))
+        self.assertEqual(ndt.discover_json(u'null\n"a"\n'), ndt.type('?string'))
+
+    def test_struct(self):
+        text = u'{"x": 1, "y": "a"}\n\n{"x": 2.5, "z": [1, 2]}\n{"x": 3, "z": []}\n'
+        self.assertEqual(ndt.discover_json(text),
+                         ndt.type('{x: float64, y: ?string, z: var * int64}'))
+
+    def test_optional_struct(self):
+        # A nested object missing from some records
+        text = u'{"a": 1, "b": {"c": 2}}\n{"a": 2}\n{"a": 3, "b": {"c": 4}}\n'
+        self.assertEqual(ndt.discover_json(text),
+                         ndt.type('{a: int64, b: ?json}'))
+        self.assertEqual(ndt.discover_json(u'{"c": 1}\nnull\n'), ndt.type('?json'))
+
+    def test_mixed(self):
+        self.assertEqual(ndt.discover_json(u'1\n"a"\n'), ndt.type('json'))
+
+    def test_sample_rows(self):
+        lines = [u'%d\n' % i for i in range(100)] + [u'"a"\n']
+        self.assertEqual(ndt.discover_json(lines, sample_rows=100), ndt.int64)
+        self.assertEqual(ndt.discover_json(lines, sample_rows=10, strided=True),
+                         ndt.type('json'))
+        # The strided sample skips lines between the first and the last
+        lines = [u'0\n', u'"a"\n'] + [u'%d\n' % i for i in range(99)]
+        self.assertEqual(ndt.discover_json(lines, sample_rows=10, strided=True),
+                         ndt.int64)
+
+    def test_strided_iterator(self):
+        # Lines are consumed from an iterator in one pass
+        lines = (u'%d\n' % i if i != 99999 else u'"a"\n' for i in range(100000))
+        self.assertEqual(ndt.discover_json(lines, sample_rows=10, strided=True),
+                         ndt.type('json'))
+
+    def test_file(self):
+        f = io.BytesIO(b'{"a": [1.5]}\n{"a": [2, 3]}\n')
+        self.assertEqual(ndt.discover_json(f),
+                         ndt.type('{a: var * float64}'))
+
+if __name__ == '__main__':
+    unittest.main(verbosity=2)
@@ -12,7 +12,7 @@ cdef api _type as_cpp_type(object o) except *
 cpdef type astype(object o)
 
 cdef object as_numba_type(_type)
-cdef _type from_numba_type(object)
+cdef _type from_numba_type(object) except *
 cdef api _type cpp_type_for(object) except *
 
 cdef void _register_nd_array_type_deduction(PyTypeObject *array_type, _type (*get_type)(PyObject *))
@@ -762,9 +762,8 @@ except ImportError:
 cdef as_numba_type(_type tp):
     return _to_numba_type[tp.get_id()]
 
-cdef _type from_numba_type(tp):
-    pass
-#    return _get_reg_info((<type_id_t> _from_numba_type[tp])).tp
+cdef _type from_numba_type(tp) except *:
+    return _type(<type_id_t> _from_numba_type[tp])
 
 cdef _type cpp_type_for(object obj) except *:
     cdef _type tp = xtype_for_prefix(obj)
@@ -1,5 +1,10 @@
+from .cpp.type cimport type
+
 cdef extern from 'types/pyobject_type.hpp':
     int pyobject_id
 
     cdef cppclass pyobject_type:
         pass
+
+cdef extern from 'types/pyobject_type.hpp' namespace 'pydynd':
+    bint type_contains_pyobject(const type&) nogil
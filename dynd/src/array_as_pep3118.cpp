@@ -6,6 +6,7 @@
 #include <Python.h>
 
 #include <dynd/shape_tools.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/fixed_string_type.hpp>
 #include <dynd/types/struct_type.hpp>
 
@@ -204,6 +205,173 @@ std::string pydynd::make_pep3118_format(intptr_t &out_itemsize, const ndt::type
   return result.str();
 }
 
+static bool pep3118_native_is_little_endian()
+{
+  const uint16_t probe = 1;
+  return *reinterpret_cast<const uint8_t *>(&probe) == 1;
+}
+
+static intptr_t parse_pep3118_count(const char *&format)
+{
+  intptr_t count = 0;
+  while (*format >= '0' && *format <= '9') {
+    count = count * 10 + (*format - '0');
+    ++format;
+  }
+  return count;
+}
+
+static ndt::type parse_pep3118_scalar(char code, bool native_sizes)
+{
+  switch (code) {
+  case '?':
+    return ndt::make_type<bool1>();
+  case 'b':
+    return ndt::make_type<int8_t>();
+  case 'B':
+    return ndt::make_type<uint8_t>();
+  case 'h':
+    return native_sizes ? ndt::make_type<short>() : ndt::make_type<int16_t>();
+  case 'H':
+    return native_sizes ? ndt::make_type<unsigned short>() : ndt::make_type<uint16_t>();
+  case 'i':
+    return native_sizes ? ndt::make_type<int>() : ndt::make_type<int32_t>();
+  case 'I':
+    return native_sizes ? ndt::make_type<unsigned int>() : ndt::make_type<uint32_t>();
+  case 'l':
+    return native_sizes ? ndt::make_type<long>() : ndt::make_type<int32_t>();
+  case 'L':
+    return native_sizes ? ndt::make_type<unsigned long>() : ndt::make_type<uint32_t>();
+  case 'q':
+    return native_sizes ? ndt::make_type<long long>() : ndt::make_type<int64_t>();
+  case 'Q':
+    return native_sizes ? ndt::make_type<unsigned long long>() : ndt::make_type<uint64_t>();
+  case 'n':
+    return native_sizes ? ndt::make_type<intptr_t>() : ndt::type();
+  case 'N':
+    return native_sizes ? ndt::make_type<uintptr_t>() : ndt::type();
+  case 'f':
+    return ndt::make_type<float>();
+  case 'd':
+    return ndt::make_type<double>();
+  default:
+    return ndt::type();
+  }
+}
+
+ndt::type pydynd::make_type_from_pep3118_format(intptr_t &out_itemsize, const char *format)
+{
+  // A NULL format means unsigned bytes, as documented by PEP 3118
+  if (format == NULL) {
+    out_itemsize = 1;
+    return ndt::make_type<uint8_t>();
+  }
+
+  const char *fmt = format;
+  bool native_sizes = true, swapped = false;
+  switch (*fmt) {
+  case '@':
+    ++fmt;
+    break;
+  case '=':
+    native_sizes = false;
+    ++fmt;
+    break;
+  case '<':
+    native_sizes = false;
+    swapped = !pep3118_native_is_little_endian();
+    ++fmt;
+    break;
+  case '>':
+  case '!':
+    native_sizes = false;
+    swapped = pep3118_native_is_little_endian();
+    ++fmt;
+    break;
+  default:
+    break;
+  }
+
+  // An optional subarray shape, like "(2,3)d"
+  std::vector<intptr_t> shape;
+  if (*fmt == '(') {
+    do {
+      ++fmt;
+      intptr_t dim_size = parse_pep3118_count(fmt);
+      if (dim_size <= 0) {
+        break;
+      }
+      shape.push_back(dim_size);
+    } while (*fmt == ',');
+    if (*fmt++ != ')') {
+      shape.clear();
+      fmt = "";
+    }
+  }
+
+  // An optional repeat count, which is the string length for 's' and 'w'
+  intptr_t count = parse_pep3118_count(fmt);
+  bool has_count = count != 0;
+  if (!has_count) {
+    count = 1;
+  }
+
+  ndt::type tp;
+  switch (*fmt) {
+  case 'c':
+    if (!has_count) {
+      tp = ndt::make_type<ndt::fixed_string_type>(1, string_encoding_ascii);
+    }
+    break;
+  case 's':
+    tp = ndt::make_type<ndt::fixed_string_type>(count, string_encoding_ascii);
+    count = 1;
+    break;
+  case 'w':
+    if (!swapped) {
+      tp = ndt::make_type<ndt::fixed_string_type>(count, string_encoding_utf_32);
+    }
+    count = 1;
+    break;
+  case 'Z':
+    ++fmt;
+    if (*fmt == 'f') {
+      tp = ndt::make_type<dynd::complex<float>>();
+    }
+    else if (*fmt == 'd') {
+      tp = ndt::make_type<dynd::complex<double>>();
+    }
+    break;
+  default:
+    if (*fmt != '\0') {
+      tp = parse_pep3118_scalar(*fmt, native_sizes);
+    }
+    break;
+  }
+
+  // Only a single item is supported, so structs ("T{...}"), padding and
+  // multi-item formats fall through to the error
+  if (tp.is_null() || *++fmt != '\0') {
+    stringstream ss;
+    ss << "Cannot convert PEP 3118 format string \"" << format << "\" into a dynd type";
+    throw dynd::type_error(ss.str());
+  }
+  if (swapped && tp.get_data_size() > 1 && tp.get_id() != fixed_string_id) {
+    stringstream ss;
+    ss << "Cannot convert PEP 3118 format string \"" << format << "\" with non-native byte order into a dynd type";
+    throw dynd::type_error(ss.str());
+  }
+
+  if (count > 1) {
+    tp = ndt::make_fixed_dim(count, tp);
+  }
+  for (intptr_t i = static_cast<intptr_t>(shape.size()) - 1; i >= 0; --i) {
+    tp = ndt::make_fixed_dim(shape[i], tp);
+  }
+  out_itemsize = tp.get_data_size();
+  return tp;
+}
+
 static void array_getbuffer_pep3118_bytes(const ndt::type &tp, const char *arrmeta, char *data, Py_buffer *buffer,
                                           int flags)
 {
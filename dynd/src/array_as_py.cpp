@@ -0,0 +1,292 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <Python.h>
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include <dynd/types/fixed_dim_type.hpp>
+
+#include "array_as_py.hpp"
+#include "utility_functions.hpp"
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+inline PyObject *pyint_from_long(long v)
+{
+#if PY_VERSION_HEX >= 0x03000000
+  return PyLong_FromLong(v);
+#else
+  return PyInt_FromLong(v);
+#endif
+}
+
+struct bool_as_py {
+  PyObject *operator()(const char *data) const
+  {
+    PyObject *result = *reinterpret_cast<const char *>(data) ? Py_True : Py_False;
+    Py_INCREF(result);
+    return result;
+  }
+};
+
+/**
+ * Converts 8-bit integers by looking them up in a table of all 256
+ * values, so each value's object is created once per conversion.
+ */
+template <typename T>
+class small_int_as_py {
+  PyObject *m_values[256];
+
+  small_int_as_py(const small_int_as_py &);
+  small_int_as_py &operator=(const small_int_as_py &);
+
+public:
+  small_int_as_py()
+  {
+    for (int i = 0; i < 256; ++i) {
+      m_values[i] = pyint_from_long(static_cast<T>(i));
+      if (m_values[i] == NULL) {
+        while (--i >= 0) {
+          Py_DECREF(m_values[i]);
+        }
+        throw std::exception();
+      }
+    }
+  }
+
+  ~small_int_as_py()
+  {
+    for (int i = 0; i < 256; ++i) {
+      Py_DECREF(m_values[i]);
+    }
+  }
+
+  PyObject *operator()(const char *data) const
+  {
+    PyObject *result = m_values[*reinterpret_cast<const uint8_t *>(data)];
+    Py_INCREF(result);
+    return result;
+  }
+};
+
+template <typename T>
+struct int_as_py {
+  PyObject *operator()(const char *data) const { return pyint_from_long(*reinterpret_cast<const T *>(data)); }
+};
+
+template <>
+struct int_as_py<uint32_t> {
+  PyObject *operator()(const char *data) const
+  {
+    return PyLong_FromUnsignedLong(*reinterpret_cast<const uint32_t *>(data));
+  }
+};
+
+template <>
+struct int_as_py<int64_t> {
+  PyObject *operator()(const char *data) const
+  {
+#if SIZEOF_LONG == 8
+    return pyint_from_long(*reinterpret_cast<const int64_t *>(data));
+#else
+    return PyLong_FromLongLong(*reinterpret_cast<const int64_t *>(data));
+#endif
+  }
+};
+
+template <>
+struct int_as_py<uint64_t> {
+  PyObject *operator()(const char *data) const
+  {
+    return PyLong_FromUnsignedLongLong(*reinterpret_cast<const uint64_t *>(data));
+  }
+};
+
+template <typename T>
+struct float_as_py {
+  PyObject *operator()(const char *data) const { return PyFloat_FromDouble(*reinterpret_cast<const T *>(data)); }
+};
+
+template <typename T>
+struct complex_as_py {
+  PyObject *operator()(const char *data) const
+  {
+    const dynd::complex<T> *val = reinterpret_cast<const dynd::complex<T> *>(data);
+    return PyComplex_FromDoubles(val->real(), val->imag());
+  }
+};
+
+/**
+ * Converts 16-bit integers by looking them up in a table covering their
+ * whole range, which is filled in as values are first seen.
+ */
+template <typename T>
+class table_int_as_py {
+  std::vector<PyObject *> m_values;
+
+  table_int_as_py(const table_int_as_py &);
+  table_int_as_py &operator=(const table_int_as_py &);
+
+public:
+  table_int_as_py() : m_values(65536, NULL) {}
+
+  ~table_int_as_py()
+  {
+    for (size_t i = 0; i < m_values.size(); ++i) {
+      Py_XDECREF(m_values[i]);
+    }
+  }
+
+  PyObject *operator()(const char *data)
+  {
+    PyObject *&result = m_values[static_cast<uint16_t>(*reinterpret_cast<const T *>(data))];
+    if (result == NULL) {
+      result = int_as_py<T>()(data);
+      if (result == NULL) {
+        return NULL;
+      }
+    }
+    Py_INCREF(result);
+    return result;
+  }
+};
+
+/**
+ * Reuses the object made for each distinct value, keyed by the value's
+ * bits. At most max_size objects are kept, so the cache stays bounded
+ * when there are many distinct values.
+ */
+template <typename Key, typename Convert>
+class hashed_as_py {
+  static const size_t max_size = 65536;
+
+  Convert m_convert;
+  std::unordered_map<Key, PyObject *> m_values;
+
+  hashed_as_py(const hashed_as_py &);
+  hashed_as_py &operator=(const hashed_as_py &);
+
+public:
+  hashed_as_py() {}
+
+  ~hashed_as_py()
+  {
+    for (typename std::unordered_map<Key, PyObject *>::iterator it = m_values.begin(); it != m_values.end(); ++it) {
+      Py_DECREF(it->second);
+    }
+  }
+
+  PyObject *operator()(const char *data)
+  {
+    Key key;
+    memcpy(&key, data, sizeof(Key));
+    typename std::unordered_map<Key, PyObject *>::iterator it = m_values.find(key);
+    if (it != m_values.end()) {
+      Py_INCREF(it->second);
+      return it->second;
+    }
+
+    PyObject *result = m_convert(data);
+    if (result != NULL && m_values.size() < max_size) {
+      Py_INCREF(result);
+      m_values[key] = result;
+    }
+    return result;
+  }
+};
+
+template <typename Convert>
+PyObject *make_pylist(intptr_t ndim, const size_stride_t *ss, const char *data, Convert &convert)
+{
+  intptr_t size = ss->dim_size, stride = ss->stride;
+  pydynd::pyobject_ownref result(PyList_New(size));
+  if (ndim == 1) {
+    for (intptr_t i = 0; i < size; ++i, data += stride) {
+      PyObject *item = convert(data);
+      if (item == NULL) {
+        throw std::exception();
+      }
+      PyList_SET_ITEM(result.get(), i, item);
+    }
+  }
+  else {
+    for (intptr_t i = 0; i < size; ++i, data += stride) {
+      PyList_SET_ITEM(result.get(), i, make_pylist(ndim - 1, ss + 1, data, convert));
+    }
+  }
+  return result.release();
+}
+
+template <typename Convert>
+PyObject *convert_pylist(intptr_t ndim, const size_stride_t *ss, const char *data)
+{
+  Convert convert;
+  return make_pylist(ndim, ss, data, convert);
+}
+
+} // anonymous namespace
+
+PyObject *pydynd::array_as_numeric_pylist(const nd::array &a, bool intern_values)
+{
+  intptr_t ndim = a.get_ndim();
+  if (ndim == 0) {
+    Py_RETURN_NONE;
+  }
+  ndt::type tp = a.get_type();
+  for (intptr_t i = 0; i < ndim; ++i) {
+    if (tp.get_id() != fixed_dim_id) {
+      Py_RETURN_NONE;
+    }
+    tp = tp.extended<ndt::fixed_dim_type>()->get_element_type();
+  }
+
+  // The arrmeta of nested fixed dimensions is one size_stride_t each
+  const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(a.get()->metadata());
+  const char *data = a.cdata();
+  switch (tp.get_id()) {
+  case bool_id:
+    return convert_pylist<bool_as_py>(ndim, ss, data);
+  case int8_id:
+    return convert_pylist<small_int_as_py<int8_t>>(ndim, ss, data);
+  case int16_id:
+    return intern_values ? convert_pylist<table_int_as_py<int16_t>>(ndim, ss, data)
+                         : convert_pylist<int_as_py<int16_t>>(ndim, ss, data);
+  case int32_id:
+    return intern_values ? convert_pylist<hashed_as_py<int32_t, int_as_py<int32_t>>>(ndim, ss, data)
+                         : convert_pylist<int_as_py<int32_t>>(ndim, ss, data);
+  case int64_id:
+    return intern_values ? convert_pylist<hashed_as_py<int64_t, int_as_py<int64_t>>>(ndim, ss, data)
+                         : convert_pylist<int_as_py<int64_t>>(ndim, ss, data);
+  case uint8_id:
+    return convert_pylist<small_int_as_py<uint8_t>>(ndim, ss, data);
+  case uint16_id:
+    return intern_values ? convert_pylist<table_int_as_py<uint16_t>>(ndim, ss, data)
+                         : convert_pylist<int_as_py<uint16_t>>(ndim, ss, data);
+  case uint32_id:
+    return intern_values ? convert_pylist<hashed_as_py<uint32_t, int_as_py<uint32_t>>>(ndim, ss, data)
+                         : convert_pylist<int_as_py<uint32_t>>(ndim, ss, data);
+  case uint64_id:
+    return intern_values ? convert_pylist<hashed_as_py<uint64_t, int_as_py<uint64_t>>>(ndim, ss, data)
+                         : convert_pylist<int_as_py<uint64_t>>(ndim, ss, data);
+  case float32_id:
+    return intern_values ? convert_pylist<hashed_as_py<uint32_t, float_as_py<float>>>(ndim, ss, data)
+                         : convert_pylist<float_as_py<float>>(ndim, ss, data);
+  case float64_id:
+    return intern_values ? convert_pylist<hashed_as_py<uint64_t, float_as_py<double>>>(ndim, ss, data)
+                         : convert_pylist<float_as_py<double>>(ndim, ss, data);
+  case complex_float32_id:
+    return convert_pylist<complex_as_py<float>>(ndim, ss, data);
+  case complex_float64_id:
+    return convert_pylist<complex_as_py<double>>(ndim, ss, data);
+  default:
+    Py_RETURN_NONE;
+  }
+}
@@ -13,6 +13,7 @@
 #include <dynd/option.hpp>
 #include <dynd/type_promotion.hpp>
 #include <dynd/types/bytes_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/option_type.hpp>
 #include <dynd/types/string_type.hpp>
 #include <dynd/types/struct_type.hpp>
@@ -20,6 +21,7 @@
 #include <dynd/types/type_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
 
+#include "array_as_pep3118.hpp"
 #include "array_conversions.hpp"
 #include "array_from_py.hpp"
 #include "array_functions.hpp"
@@ -230,8 +232,346 @@ static void fill_array_from_pylist(const ndt::type &tp, const char *arrmeta, cha
   }
 }
 
+namespace {
+
+/**
+ * The scalar kinds the single pass list builder knows how to store,
+ * ordered so that promoting two kinds is taking the maximum. This
+ * mirrors what promote_types_arithmetic produces for the types
+ * dynd_ndt_cpp_type_for deduces from Python bools, ints, floats and
+ * complex numbers.
+ */
+enum pylist_leaf_kind_t {
+  pylist_leaf_none,
+  pylist_leaf_bool,
+  pylist_leaf_int32,
+  pylist_leaf_int64,
+  pylist_leaf_float64,
+  pylist_leaf_complex_float64
+};
+
+inline size_t pylist_leaf_size(pylist_leaf_kind_t kind)
+{
+  switch (kind) {
+  case pylist_leaf_bool:
+    return sizeof(dynd::bool1);
+  case pylist_leaf_int32:
+    return sizeof(int32_t);
+  case pylist_leaf_int64:
+    return sizeof(int64_t);
+  case pylist_leaf_float64:
+    return sizeof(double);
+  case pylist_leaf_complex_float64:
+    return sizeof(dynd::complex<double>);
+  default:
+    return 0;
+  }
+}
+
+inline ndt::type pylist_leaf_type(pylist_leaf_kind_t kind)
+{
+  switch (kind) {
+  case pylist_leaf_bool:
+    return ndt::make_type<bool>();
+  case pylist_leaf_int32:
+    return ndt::make_type<int32_t>();
+  case pylist_leaf_int64:
+    return ndt::make_type<int64_t>();
+  case pylist_leaf_float64:
+    return ndt::make_type<double>();
+  case pylist_leaf_complex_float64:
+    return ndt::make_type<dynd::complex<double>>();
+  default:
+    return ndt::type();
+  }
+}
+
+/**
+ * Widens `count` values of type SrcType at the start of `data` to
+ * DstType. The destination element is never smaller than the source
+ * element, so walking from the back converts the buffer in place.
+ */
+template <typename DstType, typename SrcType>
+void promote_pylist_values(char *data, intptr_t count)
+{
+  const SrcType *src = reinterpret_cast<const SrcType *>(data);
+  DstType *dst = reinterpret_cast<DstType *>(data);
+  for (intptr_t i = count - 1; i >= 0; --i) {
+    SrcType value = src[i];
+    dst[i] = static_cast<DstType>(value);
+  }
+}
+
+template <typename SrcType>
+void promote_pylist_values(pylist_leaf_kind_t dst_kind, char *data, intptr_t count)
+{
+  switch (dst_kind) {
+  case pylist_leaf_int32:
+    promote_pylist_values<int32_t, SrcType>(data, count);
+    break;
+  case pylist_leaf_int64:
+    promote_pylist_values<int64_t, SrcType>(data, count);
+    break;
+  case pylist_leaf_float64:
+    promote_pylist_values<double, SrcType>(data, count);
+    break;
+  case pylist_leaf_complex_float64:
+    promote_pylist_values<dynd::complex<double>, SrcType>(data, count);
+    break;
+  default:
+    throw runtime_error("internal error: invalid promotion in the Python list builder");
+  }
+}
+
+void free_pylist_buffer(void *data) { free(data); }
+
+/**
+ * Converts a nested Python list into a strided array while walking it
+ * only once. The type is deduced as values are written into a growable
+ * buffer, and when a later value needs a wider type the values written
+ * so far are promoted in place.
+ *
+ * Only rectangular lists of bool, int, float and complex values are
+ * handled. Anything else makes build() return false, and the caller
+ * falls back to the deduce-then-fill path.
+ */
+class pylist_builder {
+  std::vector<intptr_t> m_shape;
+  pylist_leaf_kind_t m_kind;
+  char *m_data;
+  intptr_t m_size, m_capacity;
+
+  // Non-copyable
+  pylist_builder(const pylist_builder &);
+  pylist_builder &operator=(const pylist_builder &);
+
+  void reserve(intptr_t capacity, size_t elsize)
+  {
+    if (capacity > m_capacity || elsize > pylist_leaf_size(m_kind)) {
+      capacity = max(capacity, m_capacity);
+      char *data = reinterpret_cast<char *>(realloc(m_data, max<intptr_t>(capacity, 1) * elsize));
+      if (data == NULL) {
+        throw bad_alloc();
+      }
+      m_data = data;
+      m_capacity = capacity;
+    }
+  }
+
+  void promote(pylist_leaf_kind_t kind)
+  {
+    if (m_size != 0) {
+      reserve(m_capacity, pylist_leaf_size(kind));
+      switch (m_kind) {
+      case pylist_leaf_bool:
+        promote_pylist_values<dynd::bool1>(kind, m_data, m_size);
+        break;
+      case pylist_leaf_int32:
+        promote_pylist_values<int32_t>(kind, m_data, m_size);
+        break;
+      case pylist_leaf_int64:
+        promote_pylist_values<int64_t>(kind, m_data, m_size);
+        break;
+      case pylist_leaf_float64:
+        promote_pylist_values<double>(kind, m_data, m_size);
+        break;
+      default:
+        throw runtime_error("internal error: invalid promotion in the Python list builder");
+      }
+    }
+    else if (m_capacity != 0) {
+      reserve(m_capacity, pylist_leaf_size(kind));
+    }
+    m_kind = kind;
+  }
+
+  template <typename T>
+  void push_back(pylist_leaf_kind_t kind, const T &value)
+  {
+    if (kind > m_kind) {
+      promote(kind);
+    }
+    if (m_size == m_capacity) {
+      reserve(2 * m_capacity + 16, pylist_leaf_size(m_kind));
+    }
+    char *dst = m_data + m_size * pylist_leaf_size(m_kind);
+    switch (m_kind) {
+    case pylist_leaf_bool:
+      *reinterpret_cast<dynd::bool1 *>(dst) = dynd::bool1(value != T(0));
+      break;
+    case pylist_leaf_int32:
+      *reinterpret_cast<int32_t *>(dst) = static_cast<int32_t>(value);
+      break;
+    case pylist_leaf_int64:
+      *reinterpret_cast<int64_t *>(dst) = static_cast<int64_t>(value);
+      break;
+    case pylist_leaf_float64:
+      *reinterpret_cast<double *>(dst) = static_cast<double>(value);
+      break;
+    default:
+      *reinterpret_cast<dynd::complex<double> *>(dst) = dynd::complex<double>(static_cast<double>(value), 0.0);
+      break;
+    }
+    ++m_size;
+  }
+
+  void push_back(const dynd::complex<double> &value)
+  {
+    if (pylist_leaf_complex_float64 > m_kind) {
+      promote(pylist_leaf_complex_float64);
+    }
+    if (m_size == m_capacity) {
+      reserve(2 * m_capacity + 16, sizeof(dynd::complex<double>));
+    }
+    reinterpret_cast<dynd::complex<double> *>(m_data)[m_size++] = value;
+  }
+
+  bool append_scalar(PyObject *obj)
+  {
+    if (PyBool_Check(obj)) {
+      push_back(pylist_leaf_bool, static_cast<int32_t>(obj == Py_True));
+    }
+#if PY_VERSION_HEX < 0x03000000
+    else if (PyInt_Check(obj)) {
+      long value = PyInt_AS_LONG(obj);
+      if (value >= INT_MIN && value <= INT_MAX) {
+        push_back(pylist_leaf_int32, static_cast<int32_t>(value));
+      }
+      else {
+        push_back(pylist_leaf_int64, static_cast<int64_t>(value));
+      }
+    }
+#endif
+    else if (PyLong_Check(obj)) {
+      int overflow = 0;
+      PY_LONG_LONG value = PyLong_AsLongLongAndOverflow(obj, &overflow);
+      if (overflow != 0) {
+        // Too big for int64, let the two pass path report it
+        return false;
+      }
+      if (value == -1 && PyErr_Occurred()) {
+        throw exception();
+      }
+      if (value >= INT_MIN && value <= INT_MAX) {
+        push_back(pylist_leaf_int32, static_cast<int32_t>(value));
+      }
+      else {
+        push_back(pylist_leaf_int64, static_cast<int64_t>(value));
+      }
+    }
+    else if (PyFloat_Check(obj)) {
+      push_back(pylist_leaf_float64, PyFloat_AS_DOUBLE(obj));
+    }
+    else if (PyComplex_Check(obj)) {
+      push_back(dynd::complex<double>(PyComplex_RealAsDouble(obj), PyComplex_ImagAsDouble(obj)));
+    }
+    else {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool append(PyObject *obj, size_t current_axis)
+  {
+    Py_ssize_t size = PyList_GET_SIZE(obj);
+    if (m_shape.size() == current_axis) {
+      // Only the first visit to a depth may extend the shape, later
+      // visits are either more lists of the same size or scalars
+      if (m_size != 0) {
+        return false;
+      }
+      m_shape.push_back(size);
+    }
+    else if (m_shape[current_axis] != size) {
+      // A ragged list needs a var dimension
+      return false;
+    }
+
+    for (Py_ssize_t i = 0; i < size; ++i) {
+      PyObject *item = PyList_GET_ITEM(obj, i);
+      if (PyList_Check(item)) {
+        if (!append(item, current_axis + 1)) {
+          return false;
+        }
+      }
+      else if (m_shape.size() != current_axis + 1 || !append_scalar(item)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+public:
+  pylist_builder() : m_kind(pylist_leaf_none), m_data(NULL), m_size(0), m_capacity(0) {}
+
+  ~pylist_builder() { free(m_data); }
+
+  /**
+   * Walks the nested list once, storing its values. Returns false
+   * if the list isn't something this builder can represent.
+   */
+  bool build(PyObject *obj)
+  {
+    // Guess the element count by following the first element of each
+    // nested list, so a rectangular list never needs to regrow
+    intptr_t capacity = 1;
+    PyObject *item = obj;
+    while (PyList_Check(item) && PyList_GET_SIZE(item) > 0) {
+      capacity *= PyList_GET_SIZE(item);
+      item = PyList_GET_ITEM(item, 0);
+    }
+    reserve(capacity, sizeof(dynd::bool1));
+
+    return append(obj, 0) && m_kind != pylist_leaf_none;
+  }
+
+  /**
+   * Hands the buffer over to a new strided array, without copying.
+   */
+  nd::array release()
+  {
+    intptr_t ndim = m_shape.size();
+    dimvector strides(ndim);
+    intptr_t stride = pylist_leaf_size(m_kind);
+    for (intptr_t i = ndim - 1; i >= 0; --i) {
+      strides[i] = m_shape[i] > 1 ? stride : 0;
+      stride *= m_shape[i];
+    }
+
+    nd::memory_block memblock = nd::make_memory_block<nd::external_memory_block>(m_data, &free_pylist_buffer);
+    char *data = m_data;
+    m_data = NULL;
+    m_size = m_capacity = 0;
+
+    return nd::make_strided_array_from_data(pylist_leaf_type(m_kind), ndim, m_shape.data(), strides.get(),
+                                            nd::read_access_flag | nd::write_access_flag, data,
+                                            nd::memory_block(std::move(memblock).get(), true), NULL);
+  }
+};
+
+} // anonymous namespace
+
+dynd::nd::array pydynd::array_from_numeric_pylist(PyObject *obj)
+{
+  pylist_builder builder;
+  if (!builder.build(obj)) {
+    return nd::array();
+  }
+
+  return builder.release();
+}
+
 static dynd::nd::array array_from_pylist(PyObject *obj)
 {
+  // Most lists are rectangular and numeric, which can be converted
+  // in a single pass over the data
+  nd::array result = array_from_numeric_pylist(obj);
+  if (!result.is_null()) {
+    return result;
+  }
+
   // TODO: Add ability to specify access flags (e.g. immutable)
   // Do a pass through all the data to deduce its type and shape
   vector<intptr_t> shape;
@@ -313,6 +653,99 @@ static dynd::nd::array array_from_pylist(PyObject *obj)
   return result;
 }
 
+/**
+ * Releases a Py_buffer that was allocated by array_from_pep3118_buffer.
+ * Like py_decref_function, this may be called from any thread, so it
+ * takes the GIL.
+ */
+static void release_pep3118_buffer(void *ptr)
+{
+  if (ptr != NULL) {
+    PyGILState_RAII pgs;
+    Py_buffer *buffer = reinterpret_cast<Py_buffer *>(ptr);
+    PyBuffer_Release(buffer);
+    delete buffer;
+  }
+}
+
+dynd::nd::array pydynd::array_from_pep3118_buffer(PyObject *obj, uint32_t access_flags, bool always_copy)
+{
+  // If a copy isn't requested, make sure the access flags are ok
+  if (!always_copy && (access_flags & nd::immutable_access_flag)) {
+    throw runtime_error("cannot view a python buffer as immutable");
+  }
+
+  int flags = PyBUF_STRIDES | PyBUF_FORMAT;
+  if (!always_copy && (access_flags & nd::write_access_flag)) {
+    flags |= PyBUF_WRITABLE;
+  }
+  Py_buffer *buffer = new Py_buffer;
+  if (PyObject_GetBuffer(obj, buffer, flags) < 0) {
+    delete buffer;
+    throw exception();
+  }
+  // From here on the memory block owns the buffer, releasing it
+  // whether or not the view is successfully created
+  nd::memory_block memblock =
+      nd::make_memory_block<nd::external_memory_block>(reinterpret_cast<void *>(buffer), &release_pep3118_buffer);
+
+  intptr_t itemsize = 0;
+  ndt::type tp = make_type_from_pep3118_format(itemsize, buffer->format);
+  if (itemsize != buffer->itemsize) {
+    stringstream ss;
+    ss << "PEP 3118 buffer has itemsize " << buffer->itemsize << ", but its format \""
+       << (buffer->format ? buffer->format : "B") << "\" has size " << itemsize;
+    throw runtime_error(ss.str());
+  }
+
+  // Subarray dimensions of the format become trailing C-order dimensions
+  intptr_t ndim = buffer->ndim;
+  std::vector<intptr_t> shape(buffer->shape, buffer->shape + ndim);
+  std::vector<intptr_t> strides;
+  if (buffer->strides != NULL) {
+    strides.assign(buffer->strides, buffer->strides + ndim);
+  }
+  else {
+    // Only ndim <= 1 buffers may omit the strides when PyBUF_STRIDES is requested
+    strides.assign(ndim, itemsize);
+  }
+  std::vector<intptr_t> sub_shape;
+  while (tp.get_id() == fixed_dim_id) {
+    const ndt::fixed_dim_type *fdt = tp.extended<ndt::fixed_dim_type>();
+    sub_shape.push_back(fdt->get_fixed_dim_size());
+    tp = fdt->get_element_type();
+  }
+  intptr_t sub_stride = tp.get_data_size();
+  strides.resize(ndim + sub_shape.size());
+  for (intptr_t i = static_cast<intptr_t>(sub_shape.size()) - 1; i >= 0; --i) {
+    strides[ndim + i] = sub_stride;
+    sub_stride *= sub_shape[i];
+  }
+  shape.insert(shape.end(), sub_shape.begin(), sub_shape.end());
+
+  // DyND kernels assume aligned data, so reject exporters like packed
+  // ctypes structures which don't provide it
+  size_t alignment = tp.get_data_alignment();
+  bool aligned = (reinterpret_cast<uintptr_t>(buffer->buf) & (alignment - 1)) == 0;
+  for (size_t i = 0; i < strides.size(); ++i) {
+    aligned = aligned && (static_cast<uintptr_t>(strides[i]) & (alignment - 1)) == 0;
+  }
+  if (!aligned) {
+    stringstream ss;
+    ss << "cannot view unaligned PEP 3118 buffer data as dynd type " << tp;
+    throw runtime_error(ss.str());
+  }
+
+  nd::array result = nd::make_strided_array_from_data(
+      tp, static_cast<intptr_t>(shape.size()), shape.data(), strides.data(),
+      nd::read_access_flag | (buffer->readonly ? 0 : nd::write_access_flag), reinterpret_cast<char *>(buffer->buf),
+      nd::memory_block(std::move(memblock).get(), true), NULL);
+  if (always_copy) {
+    return result.eval_copy(access_flags);
+  }
+  return result;
+}
+
 dynd::nd::array pydynd::array_from_py(PyObject *obj, uint32_t access_flags, bool always_copy)
 {
   // If it's a Cython w_array
@@ -465,6 +898,10 @@ dynd::nd::array pydynd::array_from_py(PyObject *obj, uint32_t access_flags, bool
     result = nd::array(dynd_ndt_cpp_type_for(obj));
 #endif // DYND_NUMPY_INTEROP
   }
+  else if (PyObject_CheckBuffer(obj)) {
+    // Any other PEP 3118 exporter, like array.array, memoryview or mmap
+    return array_from_pep3118_buffer(obj, access_flags, always_copy);
+  }
 
   if (result.get() == NULL) {
     pyobject_ownref pytpstr(PyObject_Str((PyObject *)Py_TYPE(obj)));
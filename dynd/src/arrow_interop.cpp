@@ -0,0 +1,877 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <Python.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <dynd/memblock/external_memory_block.hpp>
+#include <dynd/option.hpp>
+#include <dynd/types/bytes_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+#include "array_functions.hpp"
+#include "arrow_interop.hpp"
+#include "utility_functions.hpp"
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * Returns the element type of a 1D strided array, and its size and stride,
+ * or a null type if the array isn't 1D strided.
+ */
+ndt::type get_1d_strided(const nd::array &a, intptr_t &out_dim_size, intptr_t &out_stride)
+{
+  const ndt::type &tp = a.get_type();
+  if (tp.get_id() != fixed_dim_id) {
+    return ndt::type();
+  }
+  const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(a.get()->metadata());
+  out_dim_size = ss->dim_size;
+  out_stride = ss->stride;
+  return tp.extended<ndt::fixed_dim_type>()->get_element_type();
+}
+
+/**
+ * Makes a 1D view of `size` elements of type `tp` starting at `data`,
+ * copying the element arrmeta from `arrmeta`. The view doesn't hold a
+ * reference to the data, so it must not outlive its source.
+ */
+nd::array make_strided_view(const ndt::type &tp, const char *arrmeta, char *data, intptr_t stride, intptr_t size,
+                            uint64_t access_flags)
+{
+  char *el_arrmeta = NULL;
+  nd::array result =
+      nd::make_strided_array_from_data(tp, 1, &size, &stride, access_flags, data, nd::memory_block(), &el_arrmeta);
+  if (tp.get_arrmeta_size() > 0) {
+    tp.extended()->arrmeta_copy_construct(el_arrmeta, arrmeta, nd::memory_block());
+  }
+  return result;
+}
+
+inline bool bit_is_set(const uint8_t *bits, int64_t i) { return ((bits[i >> 3] >> (i & 7)) & 1) != 0; }
+
+inline void set_bit(uint8_t *bits, int64_t i) { bits[i >> 3] |= static_cast<uint8_t>(1 << (i & 7)); }
+
+/**
+ * A run of `size` elements, `stride` bytes apart.
+ */
+struct segment {
+  const char *data;
+  intptr_t stride;
+  intptr_t size;
+};
+
+/**
+ * The elements of a column, as a sequence of strided runs. A column taken
+ * from inside var dimensions or structs is generally scattered across
+ * memory, and adjacent runs are merged so that a column laid out
+ * contiguously ends up as a single run.
+ */
+struct column {
+  ndt::type tp;
+  const char *arrmeta;
+  std::vector<segment> segments;
+  intptr_t length;
+
+  column(const ndt::type &tp, const char *arrmeta) : tp(tp), arrmeta(arrmeta), length(0) {}
+
+  void append(const char *data, intptr_t stride, intptr_t size)
+  {
+    if (size <= 0) {
+      return;
+    }
+    length += size;
+    if (!segments.empty()) {
+      // The stride of a single element run is free, so pick whichever
+      // one makes the runs line up
+      segment &last = segments.back();
+      intptr_t last_stride = last.stride;
+      if (last.size == 1) {
+        last_stride = (size == 1) ? data - last.data : stride;
+      }
+      if ((size == 1 || stride == last_stride) && last.data + last.size * last_stride == data) {
+        last.stride = last_stride;
+        last.size += size;
+        return;
+      }
+    }
+    segment s = {data, stride, size};
+    segments.push_back(s);
+  }
+
+  /**
+   * Calls f(element, index) for every element.
+   */
+  template <typename F>
+  void for_each(F f) const
+  {
+    intptr_t index = 0;
+    for (size_t j = 0; j < segments.size(); ++j) {
+      const segment &s = segments[j];
+      for (intptr_t i = 0; i < s.size; ++i, ++index) {
+        f(s.data + i * s.stride, index);
+      }
+    }
+  }
+
+  /**
+   * Returns a pointer to the elements if they are laid out contiguously
+   * `itemsize` bytes apart, otherwise NULL.
+   */
+  const char *contiguous(intptr_t itemsize) const
+  {
+    if (segments.size() == 1 && (segments[0].size == 1 || segments[0].stride == itemsize)) {
+      return segments[0].data;
+    }
+    return NULL;
+  }
+};
+
+uint64_t get_string_column_size(const column &col, const uint8_t *valid)
+{
+  uint64_t total_size = 0;
+  col.for_each([&](const char *el, intptr_t i) {
+    if (valid == NULL || bit_is_set(valid, i)) {
+      const dynd::bytes *s = reinterpret_cast<const dynd::bytes *>(el);
+      total_size += s->end() - s->begin();
+    }
+  });
+  return total_size;
+}
+
+template <typename OffsetType>
+void fill_string_offsets(const column &col, const uint8_t *valid, char *offsets, char *data)
+{
+  OffsetType *out_offsets = reinterpret_cast<OffsetType *>(offsets);
+  OffsetType offset = 0;
+  out_offsets[0] = 0;
+  col.for_each([&](const char *el, intptr_t i) {
+    if (valid == NULL || bit_is_set(valid, i)) {
+      const dynd::bytes *s = reinterpret_cast<const dynd::bytes *>(el);
+      size_t size = s->end() - s->begin();
+      if (size != 0) {
+        memcpy(data + offset, s->begin(), size);
+      }
+      offset += static_cast<OffsetType>(size);
+    }
+    out_offsets[i + 1] = offset;
+  });
+}
+
+template <typename OffsetType>
+void fill_strings_from_offsets(const char *offsets, intptr_t offsets_stride, const char *data, intptr_t data_size,
+                               intptr_t dim_size, char *dst, intptr_t dst_stride)
+{
+  OffsetType begin = *reinterpret_cast<const OffsetType *>(offsets);
+  for (intptr_t i = 0; i < dim_size; ++i, dst += dst_stride) {
+    offsets += offsets_stride;
+    OffsetType end = *reinterpret_cast<const OffsetType *>(offsets);
+    if (begin < 0 || end < begin || end > data_size) {
+      stringstream ss;
+      ss << "invalid string offsets [" << begin << ", " << end << ") at index " << i << " for string data of size "
+         << data_size;
+      throw invalid_argument(ss.str());
+    }
+    reinterpret_cast<dynd::bytes *>(dst)->assign(data + begin, end - begin);
+    begin = end;
+  }
+}
+
+/**
+ * The Arrow format character of a fixed size primitive type, or 0.
+ */
+char get_arrow_primitive_format(type_id_t id)
+{
+  switch (id) {
+  case int8_id:
+    return 'c';
+  case uint8_id:
+    return 'C';
+  case int16_id:
+    return 's';
+  case uint16_id:
+    return 'S';
+  case int32_id:
+    return 'i';
+  case uint32_id:
+    return 'I';
+  case int64_id:
+    return 'l';
+  case uint64_id:
+    return 'L';
+  case float16_id:
+    return 'e';
+  case float32_id:
+    return 'f';
+  case float64_id:
+    return 'g';
+  default:
+    return 0;
+  }
+}
+
+/**
+ * The dynd type of an Arrow fixed size primitive format, or a null type.
+ */
+ndt::type get_arrow_primitive_type(const char *format)
+{
+  if (format[0] == '\0' || format[1] != '\0') {
+    return ndt::type();
+  }
+  switch (format[0]) {
+  case 'c':
+    return ndt::type(int8_id);
+  case 'C':
+    return ndt::type(uint8_id);
+  case 's':
+    return ndt::type(int16_id);
+  case 'S':
+    return ndt::type(uint16_id);
+  case 'i':
+    return ndt::type(int32_id);
+  case 'I':
+    return ndt::type(uint32_id);
+  case 'l':
+    return ndt::type(int64_id);
+  case 'L':
+    return ndt::type(uint64_id);
+  case 'e':
+    return ndt::type(float16_id);
+  case 'f':
+    return ndt::type(float32_id);
+  case 'g':
+    return ndt::type(float64_id);
+  default:
+    return ndt::type();
+  }
+}
+
+// Export through the C Data Interface. Every exported ArrowArray holds a
+// reference to the source array, so buffers pointing into it stay valid
+// for as long as the consumer needs them.
+
+struct exported_schema {
+  std::string format;
+  std::string name;
+  std::vector<ArrowSchema *> children;
+};
+
+struct exported_array {
+  nd::array keepalive;
+  std::vector<nd::array> owned_buffers;
+  std::vector<const void *> buffers;
+  std::vector<ArrowArray *> children;
+};
+
+void release_exported_schema(ArrowSchema *schema)
+{
+  exported_schema *holder = static_cast<exported_schema *>(schema->private_data);
+  for (size_t i = 0; i < holder->children.size(); ++i) {
+    ArrowSchema *child = holder->children[i];
+    if (child != NULL && child->release != NULL) {
+      child->release(child);
+    }
+    delete child;
+  }
+  delete holder;
+  schema->release = NULL;
+}
+
+void release_exported_array(ArrowArray *array)
+{
+  exported_array *holder = static_cast<exported_array *>(array->private_data);
+  for (size_t i = 0; i < holder->children.size(); ++i) {
+    ArrowArray *child = holder->children[i];
+    if (child != NULL && child->release != NULL) {
+      child->release(child);
+    }
+    delete child;
+  }
+  delete holder;
+  array->release = NULL;
+}
+
+template <typename T>
+T *add_child(std::vector<T *> &children)
+{
+  children.push_back(NULL);
+  // Value initialization leaves the release callback NULL
+  children.back() = new T();
+  return children.back();
+}
+
+char *alloc_buffer(exported_array *holder, intptr_t size)
+{
+  nd::array buffer = pydynd::make_strided_array(ndt::make_type<uint8_t>(), 1, &size);
+  holder->owned_buffers.push_back(buffer);
+  char *data = buffer.data();
+  memset(data, 0, size);
+  return data;
+}
+
+void export_column(const column &col, const std::string &name, const nd::array &keepalive, ArrowSchema *schema,
+                   ArrowArray *array)
+{
+  exported_schema *sh = new exported_schema;
+  sh->name = name;
+  schema->format = "";
+  schema->name = "";
+  schema->metadata = NULL;
+  schema->flags = 0;
+  schema->n_children = 0;
+  schema->children = NULL;
+  schema->dictionary = NULL;
+  schema->release = &release_exported_schema;
+  schema->private_data = sh;
+
+  exported_array *ah = new exported_array;
+  ah->keepalive = keepalive;
+  array->length = col.length;
+  array->null_count = 0;
+  array->offset = 0;
+  array->n_buffers = 0;
+  array->n_children = 0;
+  array->buffers = NULL;
+  array->children = NULL;
+  array->dictionary = NULL;
+  array->release = &release_exported_array;
+  array->private_data = ah;
+
+  // Missing values become the validity bitmap, and the values themselves
+  // are exported using the option's value type
+  ndt::type tp = col.tp;
+  const uint8_t *valid = NULL;
+  if (tp.get_id() == option_id) {
+    uint8_t *bits = reinterpret_cast<uint8_t *>(alloc_buffer(ah, (col.length + 7) / 8));
+    int64_t null_count = 0;
+    intptr_t index = 0;
+    for (size_t j = 0; j < col.segments.size(); ++j) {
+      const segment &s = col.segments[j];
+      nd::array is_na = dynd::nd::is_na(
+          make_strided_view(tp, col.arrmeta, const_cast<char *>(s.data), s.stride, s.size, nd::read_access_flag));
+      intptr_t is_na_stride = reinterpret_cast<const size_stride_t *>(is_na.get()->metadata())->stride;
+      const char *is_na_data = is_na.cdata();
+      for (intptr_t i = 0; i < s.size; ++i, ++index) {
+        if (is_na_data[i * is_na_stride] == 0) {
+          set_bit(bits, index);
+        }
+        else {
+          ++null_count;
+        }
+      }
+    }
+    schema->flags |= ARROW_FLAG_NULLABLE;
+    array->null_count = null_count;
+    valid = bits;
+    tp = tp.extended<ndt::option_type>()->get_value_type();
+  }
+  ah->buffers.push_back(valid);
+
+  char primitive_format = get_arrow_primitive_format(tp.get_id());
+  if (primitive_format != 0) {
+    sh->format = primitive_format;
+    intptr_t itemsize = tp.get_data_size();
+    const char *data = col.contiguous(itemsize);
+    if (data == NULL) {
+      char *dst = alloc_buffer(ah, col.length * itemsize);
+      data = dst;
+      col.for_each([&](const char *el, intptr_t i) { memcpy(dst + i * itemsize, el, itemsize); });
+    }
+    ah->buffers.push_back(data);
+  }
+  else {
+    switch (tp.get_id()) {
+    case bool_id: {
+      sh->format = "b";
+      uint8_t *bits = reinterpret_cast<uint8_t *>(alloc_buffer(ah, (col.length + 7) / 8));
+      col.for_each([&](const char *el, intptr_t i) {
+        if (*el == 1) {
+          set_bit(bits, i);
+        }
+      });
+      ah->buffers.push_back(bits);
+      break;
+    }
+    case string_id:
+    case bytes_id: {
+      uint64_t total_size = get_string_column_size(col, valid);
+      bool large = total_size > static_cast<uint64_t>(numeric_limits<int32_t>::max());
+      if (tp.get_id() == string_id) {
+        sh->format = large ? "U" : "u";
+      }
+      else {
+        sh->format = large ? "Z" : "z";
+      }
+      char *offsets = alloc_buffer(ah, (col.length + 1) * (large ? sizeof(int64_t) : sizeof(int32_t)));
+      char *data = alloc_buffer(ah, static_cast<intptr_t>(total_size));
+      if (large) {
+        fill_string_offsets<int64_t>(col, valid, offsets, data);
+      }
+      else {
+        fill_string_offsets<int32_t>(col, valid, offsets, data);
+      }
+      ah->buffers.push_back(offsets);
+      ah->buffers.push_back(data);
+      break;
+    }
+    case struct_id: {
+      sh->format = "+s";
+      const ndt::struct_type *st = tp.extended<ndt::struct_type>();
+      const uintptr_t *data_offsets = st->get_data_offsets(col.arrmeta);
+      const uintptr_t *arrmeta_offsets = st->get_arrmeta_offsets_raw();
+      size_t field_count = st->get_field_count();
+      for (size_t i = 0; i < field_count; ++i) {
+        column field(st->get_field_type(i), col.arrmeta + arrmeta_offsets[i]);
+        for (size_t j = 0; j < col.segments.size(); ++j) {
+          const segment &s = col.segments[j];
+          field.append(s.data + data_offsets[i], s.stride, s.size);
+        }
+        const dynd::string &fname = st->get_field_name(i);
+        export_column(field, std::string(fname.begin(), fname.end()), keepalive, add_child(sh->children),
+                      add_child(ah->children));
+      }
+      break;
+    }
+    case var_dim_id: {
+      const ndt::var_dim_type::metadata_type *md = reinterpret_cast<const ndt::var_dim_type::metadata_type *>(col.arrmeta);
+      column child(tp.extended<ndt::var_dim_type>()->get_element_type(),
+                   col.arrmeta + sizeof(ndt::var_dim_type::metadata_type));
+      std::vector<int64_t> list_offsets(col.length + 1);
+      col.for_each([&](const char *el, intptr_t i) {
+        const ndt::var_dim_type::data_type *d = reinterpret_cast<const ndt::var_dim_type::data_type *>(el);
+        if (valid == NULL || bit_is_set(valid, i)) {
+          child.append(d->begin + md->offset, md->stride, d->size);
+        }
+        list_offsets[i + 1] = child.length;
+      });
+      bool large = child.length > numeric_limits<int32_t>::max();
+      sh->format = large ? "+L" : "+l";
+      if (large) {
+        char *offsets = alloc_buffer(ah, list_offsets.size() * sizeof(int64_t));
+        memcpy(offsets, list_offsets.data(), list_offsets.size() * sizeof(int64_t));
+        ah->buffers.push_back(offsets);
+      }
+      else {
+        int32_t *offsets = reinterpret_cast<int32_t *>(alloc_buffer(ah, list_offsets.size() * sizeof(int32_t)));
+        for (size_t i = 0; i < list_offsets.size(); ++i) {
+          offsets[i] = static_cast<int32_t>(list_offsets[i]);
+        }
+        ah->buffers.push_back(offsets);
+      }
+      export_column(child, "item", keepalive, add_child(sh->children), add_child(ah->children));
+      break;
+    }
+    case fixed_dim_id: {
+      const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(col.arrmeta);
+      stringstream format;
+      format << "+w:" << ss->dim_size;
+      sh->format = format.str();
+      column child(tp.extended<ndt::fixed_dim_type>()->get_element_type(), col.arrmeta + sizeof(size_stride_t));
+      col.for_each([&](const char *el, intptr_t DYND_UNUSED(i)) { child.append(el, ss->stride, ss->dim_size); });
+      export_column(child, "item", keepalive, add_child(sh->children), add_child(ah->children));
+      break;
+    }
+    default: {
+      stringstream ss;
+      ss << "cannot export dynd type " << tp << " through the Arrow C data interface";
+      throw dynd::type_error(ss.str());
+    }
+    }
+  }
+
+  schema->format = sh->format.c_str();
+  schema->name = sh->name.c_str();
+  schema->n_children = sh->children.size();
+  schema->children = sh->children.empty() ? NULL : sh->children.data();
+  array->n_buffers = ah->buffers.size();
+  array->buffers = ah->buffers.data();
+  array->n_children = ah->children.size();
+  array->children = ah->children.empty() ? NULL : ah->children.data();
+}
+
+void release_schema_capsule(PyObject *capsule)
+{
+  ArrowSchema *schema = static_cast<ArrowSchema *>(PyCapsule_GetPointer(capsule, "arrow_schema"));
+  if (schema->release != NULL) {
+    schema->release(schema);
+  }
+  delete schema;
+}
+
+void release_array_capsule(PyObject *capsule)
+{
+  ArrowArray *array = static_cast<ArrowArray *>(PyCapsule_GetPointer(capsule, "arrow_array"));
+  if (array->release != NULL) {
+    array->release(array);
+  }
+  delete array;
+}
+
+// Import through the C Data Interface. The imported ArrowArray is owned
+// by a memory block, which every view of its buffers references.
+
+void release_imported_array(void *ptr)
+{
+  ArrowArray *array = static_cast<ArrowArray *>(ptr);
+  if (array->release != NULL) {
+    array->release(array);
+  }
+  delete array;
+}
+
+int64_t get_list_offset(const ArrowArray *array, bool large, int64_t i)
+{
+  if (large) {
+    return static_cast<const int64_t *>(array->buffers[1])[i];
+  }
+  return static_cast<const int32_t *>(array->buffers[1])[i];
+}
+
+void assign_missing(nd::array &result, const uint8_t *validity, int64_t offset)
+{
+  const ndt::type &el_tp = result.get_type().extended<ndt::fixed_dim_type>()->get_element_type();
+  const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(result.get()->metadata());
+  const char *el_arrmeta = result.get()->metadata() + sizeof(size_stride_t);
+  char *data = result.data();
+  for (intptr_t i = 0; i < ss->dim_size; ++i) {
+    if (!bit_is_set(validity, offset + i)) {
+      nd::old_assign_na(el_tp, el_arrmeta, data + i * ss->stride);
+    }
+  }
+}
+
+nd::array import_column(const ArrowSchema *schema, const ArrowArray *array, int64_t offset, int64_t length,
+                        const nd::memory_block &owner)
+{
+  if (schema->dictionary != NULL) {
+    throw dynd::type_error("cannot import a dictionary encoded Arrow array");
+  }
+  const char *format = schema->format;
+  intptr_t size = static_cast<intptr_t>(length);
+  uint64_t rw_access = nd::read_access_flag | nd::write_access_flag;
+
+  const uint8_t *validity = array->n_buffers > 0 ? static_cast<const uint8_t *>(array->buffers[0]) : NULL;
+  bool has_missing = false;
+  if (validity != NULL && array->null_count != 0) {
+    for (int64_t i = 0; i < length && !has_missing; ++i) {
+      has_missing = !bit_is_set(validity, offset + i);
+    }
+  }
+
+  ndt::type tp = get_arrow_primitive_type(format);
+  nd::array result;
+  if (tp.get_id() != uninitialized_id) {
+    intptr_t itemsize = tp.get_data_size();
+    const char *data = static_cast<const char *>(array->buffers[1]);
+    if (data != NULL) {
+      data += offset * itemsize;
+    }
+    size_t alignment = tp.get_data_alignment();
+    if (!has_missing && (reinterpret_cast<uintptr_t>(data) & (alignment - 1)) == 0) {
+      return nd::make_strided_array_from_data(tp, 1, &size, &itemsize,
+                                              nd::read_access_flag | nd::immutable_access_flag,
+                                              const_cast<char *>(data), nd::memory_block(owner.get(), true), NULL);
+    }
+    result = pydynd::make_strided_array(has_missing ? ndt::make_type<ndt::option_type>(tp) : tp, 1, &size);
+    if (size > 0) {
+      memcpy(result.data(), data, size * itemsize);
+    }
+  }
+  else if (strcmp(format, "b") == 0) {
+    tp = ndt::type(bool_id);
+    result = pydynd::make_strided_array(has_missing ? ndt::make_type<ndt::option_type>(tp) : tp, 1, &size);
+    const uint8_t *bits = static_cast<const uint8_t *>(array->buffers[1]);
+    char *dst = result.data();
+    for (intptr_t i = 0; i < size; ++i) {
+      dst[i] = bit_is_set(bits, offset + i) ? 1 : 0;
+    }
+  }
+  else if (strcmp(format, "u") == 0 || strcmp(format, "U") == 0 || strcmp(format, "z") == 0 ||
+           strcmp(format, "Z") == 0) {
+    bool large = (format[0] == 'U' || format[0] == 'Z');
+    tp = (format[0] == 'u' || format[0] == 'U') ? ndt::make_type<ndt::string_type>()
+                                                 : ndt::make_type<ndt::bytes_type>(1);
+    result = pydynd::make_strided_array(has_missing ? ndt::make_type<ndt::option_type>(tp) : tp, 1, &size);
+    intptr_t dst_stride = reinterpret_cast<const size_stride_t *>(result.get()->metadata())->stride;
+    const char *data = static_cast<const char *>(array->buffers[2]);
+    if (size > 0) {
+      if (large) {
+        const int64_t *offsets = static_cast<const int64_t *>(array->buffers[1]) + offset;
+        fill_strings_from_offsets<int64_t>(reinterpret_cast<const char *>(offsets), sizeof(int64_t), data,
+                                           offsets[size], size, result.data(), dst_stride);
+      }
+      else {
+        const int32_t *offsets = static_cast<const int32_t *>(array->buffers[1]) + offset;
+        fill_strings_from_offsets<int32_t>(reinterpret_cast<const char *>(offsets), sizeof(int32_t), data,
+                                           offsets[size], size, result.data(), dst_stride);
+      }
+    }
+  }
+  else if (strcmp(format, "+s") == 0) {
+    // Arrow structs are stored by column, dynd structs by row, so the
+    // fields are copied in one column at a time
+    std::vector<std::string> names;
+    std::vector<ndt::type> types;
+    std::vector<nd::array> fields;
+    for (int64_t i = 0; i < schema->n_children; ++i) {
+      const ArrowArray *child = array->children[i];
+      fields.push_back(import_column(schema->children[i], child, child->offset + offset, length, owner));
+      names.push_back(schema->children[i]->name != NULL ? schema->children[i]->name : "");
+      types.push_back(fields.back().get_type().extended<ndt::fixed_dim_type>()->get_element_type());
+    }
+    tp = ndt::make_type<ndt::struct_type>(names, types);
+    result = pydynd::make_strided_array(has_missing ? ndt::make_type<ndt::option_type>(tp) : tp, 1, &size);
+    const char *struct_arrmeta = result.get()->metadata() + sizeof(size_stride_t);
+    intptr_t stride = reinterpret_cast<const size_stride_t *>(result.get()->metadata())->stride;
+    const ndt::struct_type *st = tp.extended<ndt::struct_type>();
+    const uintptr_t *data_offsets = st->get_data_offsets(struct_arrmeta);
+    const uintptr_t *arrmeta_offsets = st->get_arrmeta_offsets_raw();
+    for (size_t i = 0; i < fields.size(); ++i) {
+      nd::array dst = make_strided_view(types[i], struct_arrmeta + arrmeta_offsets[i],
+                                        result.data() + data_offsets[i], stride, size, rw_access);
+      dst.assign(fields[i]);
+    }
+  }
+  else if (strcmp(format, "+l") == 0 || strcmp(format, "+L") == 0) {
+    bool large = (format[1] == 'L');
+    const ArrowArray *child_array = array->children[0];
+    int64_t first = get_list_offset(array, large, offset);
+    int64_t last = get_list_offset(array, large, offset + length);
+    nd::array child = import_column(schema->children[0], child_array, child_array->offset + first, last - first, owner);
+    ndt::type el_tp = child.get_type().extended<ndt::fixed_dim_type>()->get_element_type();
+
+    tp = ndt::make_type<ndt::var_dim_type>(el_tp);
+    result = pydynd::make_strided_array(has_missing ? ndt::make_type<ndt::option_type>(tp) : tp, 1, &size);
+    char *arrmeta = result.get()->metadata();
+    intptr_t stride = reinterpret_cast<const size_stride_t *>(arrmeta)->stride;
+    const ndt::var_dim_type::metadata_type *md =
+        reinterpret_cast<const ndt::var_dim_type::metadata_type *>(arrmeta + sizeof(size_stride_t));
+
+    // Copy all the list elements into one allocation, which the
+    // individual lists then point into
+    intptr_t total_size = static_cast<intptr_t>(last - first);
+    char *elements = NULL;
+    if (total_size > 0) {
+      elements = md->blockref->alloc(total_size);
+      nd::array dst = make_strided_view(el_tp, arrmeta + sizeof(size_stride_t) + sizeof(ndt::var_dim_type::metadata_type),
+                                        elements, md->stride, total_size, rw_access);
+      dst.assign(child);
+    }
+    char *data = result.data();
+    for (intptr_t i = 0; i < size; ++i) {
+      int64_t begin = get_list_offset(array, large, offset + i);
+      int64_t end = get_list_offset(array, large, offset + i + 1);
+      if (begin < first || end < begin || end > last) {
+        stringstream ss;
+        ss << "invalid Arrow list offsets [" << begin << ", " << end << ") at index " << i;
+        throw invalid_argument(ss.str());
+      }
+      ndt::var_dim_type::data_type *d = reinterpret_cast<ndt::var_dim_type::data_type *>(data + i * stride);
+      d->begin = elements + (begin - first) * md->stride;
+      d->size = static_cast<size_t>(end - begin);
+    }
+    result.get_type().extended()->arrmeta_finalize_buffers(arrmeta);
+  }
+  else if (strncmp(format, "+w:", 3) == 0) {
+    if (has_missing) {
+      throw dynd::type_error("cannot import an Arrow fixed size list with missing values, dynd dimensions "
+                             "cannot be optional");
+    }
+    intptr_t dim_size = strtol(format + 3, NULL, 10);
+    const ArrowArray *child_array = array->children[0];
+    nd::array child =
+        import_column(schema->children[0], child_array, child_array->offset + offset * dim_size, length * dim_size, owner);
+    ndt::type el_tp = child.get_type().extended<ndt::fixed_dim_type>()->get_element_type();
+    intptr_t shape[2] = {size, dim_size};
+    intptr_t child_stride = reinterpret_cast<const size_stride_t *>(child.get()->metadata())->stride;
+    intptr_t itemsize = el_tp.get_data_size();
+    if (el_tp.is_builtin() && (size * dim_size <= 1 || child_stride == itemsize)) {
+      // A view of the child with the list dimension split off
+      intptr_t strides[2] = {dim_size * itemsize, itemsize};
+      return nd::make_strided_array_from_data(el_tp, 2, shape, strides, child.get_flags(),
+                                              const_cast<char *>(child.cdata()),
+                                              nd::memory_block(child.get_data_memblock().get(), true), NULL);
+    }
+    result = pydynd::make_strided_array(el_tp, 2, shape);
+    nd::array dst = make_strided_view(el_tp, result.get()->metadata() + 2 * sizeof(size_stride_t), result.data(),
+                                      itemsize, size * dim_size, rw_access);
+    dst.assign(child);
+    return result;
+  }
+  else {
+    stringstream ss;
+    ss << "cannot import Arrow array with format \"" << format << "\"";
+    throw dynd::type_error(ss.str());
+  }
+
+  if (has_missing) {
+    assign_missing(result, validity, offset);
+  }
+  return result;
+}
+
+} // anonymous namespace
+
+std::pair<nd::array, nd::array> pydynd::array_as_string_offsets(const nd::array &a, bool large_offsets)
+{
+  intptr_t dim_size = 0, stride = 0;
+  ndt::type el_tp = get_1d_strided(a, dim_size, stride);
+  if (el_tp.get_id() != string_id) {
+    stringstream ss;
+    ss << "string offsets export requires a 1D array of strings, not " << a.get_type();
+    throw dynd::type_error(ss.str());
+  }
+  column col(el_tp, a.get()->metadata() + sizeof(size_stride_t));
+  col.append(a.cdata(), stride, dim_size);
+
+  // Size the data buffer first, so it is allocated exactly once
+  uint64_t total_size = get_string_column_size(col, NULL);
+  if (!large_offsets && total_size > static_cast<uint64_t>(numeric_limits<int32_t>::max())) {
+    stringstream ss;
+    ss << "string data of " << total_size << " bytes does not fit int32 offsets, use large offsets";
+    throw overflow_error(ss.str());
+  }
+
+  intptr_t offsets_size = dim_size + 1;
+  intptr_t data_size = static_cast<intptr_t>(total_size);
+  nd::array offsets =
+      make_strided_array(large_offsets ? ndt::make_type<int64_t>() : ndt::make_type<int32_t>(), 1, &offsets_size);
+  nd::array data = make_strided_array(ndt::make_type<uint8_t>(), 1, &data_size);
+  if (large_offsets) {
+    fill_string_offsets<int64_t>(col, NULL, offsets.data(), data.data());
+  }
+  else {
+    fill_string_offsets<int32_t>(col, NULL, offsets.data(), data.data());
+  }
+
+  return std::make_pair(offsets, data);
+}
+
+nd::array pydynd::array_from_string_offsets(const nd::array &offsets, const nd::array &data)
+{
+  intptr_t offsets_size = 0, offsets_stride = 0;
+  ndt::type offsets_tp = get_1d_strided(offsets, offsets_size, offsets_stride);
+  if (offsets_tp.get_id() != int32_id && offsets_tp.get_id() != int64_id) {
+    stringstream ss;
+    ss << "string offsets must be a 1D array of int32 or int64, not " << offsets.get_type();
+    throw dynd::type_error(ss.str());
+  }
+  if (offsets_size < 1) {
+    throw invalid_argument("string offsets must hold at least one offset");
+  }
+
+  intptr_t data_size = 0, data_stride = 0;
+  ndt::type data_tp = get_1d_strided(data, data_size, data_stride);
+  if ((data_tp.get_id() != uint8_id && data_tp.get_id() != int8_id) || (data_size > 1 && data_stride != 1)) {
+    stringstream ss;
+    ss << "string data must be a 1D contiguous array of uint8, not " << data.get_type();
+    throw dynd::type_error(ss.str());
+  }
+
+  intptr_t dim_size = offsets_size - 1;
+  nd::array result = make_strided_array(ndt::make_type<ndt::string_type>(), 1, &dim_size);
+  intptr_t dst_stride = reinterpret_cast<const size_stride_t *>(result.get()->metadata())->stride;
+  if (offsets_tp.get_id() == int64_id) {
+    fill_strings_from_offsets<int64_t>(offsets.cdata(), offsets_stride, data.cdata(), data_size, dim_size,
+                                       result.data(), dst_stride);
+  }
+  else {
+    fill_strings_from_offsets<int32_t>(offsets.cdata(), offsets_stride, data.cdata(), data_size, dim_size,
+                                       result.data(), dst_stride);
+  }
+
+  return result;
+}
+
+PyObject *pydynd::array_as_arrow_c_array(const nd::array &a)
+{
+  intptr_t dim_size = 0, stride = 0;
+  ndt::type el_tp = get_1d_strided(a, dim_size, stride);
+  if (el_tp.get_id() == uninitialized_id) {
+    stringstream ss;
+    ss << "Arrow export requires an array with an outermost fixed dimension, not " << a.get_type();
+    throw dynd::type_error(ss.str());
+  }
+  column col(el_tp, a.get()->metadata() + sizeof(size_stride_t));
+  col.append(a.cdata(), stride, dim_size);
+
+  ArrowSchema *schema = new ArrowSchema();
+  ArrowArray *array = new ArrowArray();
+  try {
+    export_column(col, "", a, schema, array);
+  }
+  catch (...) {
+    if (schema->release != NULL) {
+      schema->release(schema);
+    }
+    delete schema;
+    if (array->release != NULL) {
+      array->release(array);
+    }
+    delete array;
+    throw;
+  }
+
+  PyObject *schema_capsule = PyCapsule_New(schema, "arrow_schema", &release_schema_capsule);
+  if (schema_capsule == NULL) {
+    schema->release(schema);
+    delete schema;
+    array->release(array);
+    delete array;
+    throw exception();
+  }
+  pyobject_ownref schema_obj(schema_capsule);
+  PyObject *array_capsule = PyCapsule_New(array, "arrow_array", &release_array_capsule);
+  if (array_capsule == NULL) {
+    array->release(array);
+    delete array;
+    throw exception();
+  }
+  pyobject_ownref array_obj(array_capsule);
+
+  PyObject *result = PyTuple_Pack(2, schema_obj.get(), array_obj.get());
+  if (result == NULL) {
+    throw exception();
+  }
+  return result;
+}
+
+nd::array pydynd::array_from_arrow_c_array(PyObject *schema_capsule, PyObject *array_capsule)
+{
+  ArrowSchema *schema = static_cast<ArrowSchema *>(PyCapsule_GetPointer(schema_capsule, "arrow_schema"));
+  if (schema == NULL) {
+    throw exception();
+  }
+  ArrowArray *src = static_cast<ArrowArray *>(PyCapsule_GetPointer(array_capsule, "arrow_array"));
+  if (src == NULL) {
+    throw exception();
+  }
+  if (src->release == NULL) {
+    throw invalid_argument("the Arrow array has already been released");
+  }
+
+  // Move the array out of the capsule, as the specification prescribes,
+  // so its buffers live as long as dynd references them
+  ArrowArray *array = new ArrowArray(*src);
+  src->release = NULL;
+  nd::memory_block owner =
+      nd::make_memory_block<nd::external_memory_block>(reinterpret_cast<void *>(array), &release_imported_array);
+
+  return import_column(schema, array, array->offset, array->length, owner);
+}
@@ -0,0 +1,150 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <Python.h>
+
+#include <cstring>
+#include <sstream>
+
+#include <dynd/types/categorical_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+#include "array_functions.hpp"
+#include "categorical_interop.hpp"
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+bool read_code(type_id_t id, const char *data, int64_t &out)
+{
+  switch (id) {
+  case int8_id:
+    out = *reinterpret_cast<const int8_t *>(data);
+    return true;
+  case int16_id:
+    out = *reinterpret_cast<const int16_t *>(data);
+    return true;
+  case int32_id:
+    out = *reinterpret_cast<const int32_t *>(data);
+    return true;
+  case int64_id:
+    out = *reinterpret_cast<const int64_t *>(data);
+    return true;
+  case uint8_id:
+    out = *reinterpret_cast<const uint8_t *>(data);
+    return true;
+  case uint16_id:
+    out = *reinterpret_cast<const uint16_t *>(data);
+    return true;
+  case uint32_id:
+    out = *reinterpret_cast<const uint32_t *>(data);
+    return true;
+  case uint64_id: {
+    uint64_t v = *reinterpret_cast<const uint64_t *>(data);
+    out = v > static_cast<uint64_t>(INT64_MAX) ? -1 : static_cast<int64_t>(v);
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+} // anonymous namespace
+
+std::pair<nd::array, nd::array> pydynd::array_as_categorical_codes(const nd::array &a)
+{
+  ndt::type dtp = a.get_dtype();
+  if (dtp.get_id() != categorical_id) {
+    stringstream ss;
+    ss << "categorical codes require an array of categorical type, not " << a.get_type();
+    throw dynd::type_error(ss.str());
+  }
+  const ndt::categorical_type *cd = dtp.extended<ndt::categorical_type>();
+
+  // The categorical and its integer storage both have no arrmeta of their
+  // own, so the dimensions' arrmeta is all there is to copy. The view is
+  // read-only, since writing to it would skip the range check on codes.
+  ndt::type codes_tp = a.get_type().with_replaced_dtype(cd->get_storage_type());
+  nd::array codes = nd::make_array(codes_tp, const_cast<char *>(a.cdata()), a.get_owner() ? a.get_owner() : a,
+                                   nd::read_access_flag | (a.get_flags() & nd::immutable_access_flag));
+  if (codes_tp.get_arrmeta_size() > 0) {
+    a.get_type().extended()->arrmeta_copy_construct(codes.get()->metadata(), a.get()->metadata(), a);
+  }
+
+  return std::make_pair(codes, cd->get_categories());
+}
+
+nd::array pydynd::array_from_categorical_codes(const nd::array &codes, const nd::array &categories)
+{
+  if (codes.get_type().get_id() != fixed_dim_id || codes.get_ndim() != 1) {
+    stringstream ss;
+    ss << "categorical codes must be a one-dimensional array, not " << codes.get_type();
+    throw dynd::type_error(ss.str());
+  }
+  if (categories.get_ndim() != 1) {
+    stringstream ss;
+    ss << "categories must be a one-dimensional array, not " << categories.get_type();
+    throw dynd::type_error(ss.str());
+  }
+
+  ndt::type cat_tp = ndt::make_type<ndt::categorical_type>(categories);
+  const ndt::categorical_type *cd = cat_tp.extended<ndt::categorical_type>();
+  const ndt::type &storage_tp = cd->get_storage_type();
+  int64_t category_count = static_cast<int64_t>(cd->get_category_count());
+
+  const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(codes.get()->metadata());
+  intptr_t size = ss->dim_size, stride = ss->stride;
+  type_id_t codes_id = codes.get_dtype().get_id();
+  const char *src = codes.cdata();
+  for (intptr_t i = 0; i < size; ++i, src += stride) {
+    int64_t code;
+    if (!read_code(codes_id, src, code)) {
+      stringstream ss;
+      ss << "categorical codes must be integers, not " << codes.get_dtype();
+      throw dynd::type_error(ss.str());
+    }
+    if (code < 0 || code >= category_count) {
+      stringstream ss;
+      ss << "categorical code " << code << " at index " << i << " is out of range for " << category_count
+         << " categories";
+      throw invalid_argument(ss.str());
+    }
+  }
+
+  intptr_t itemsize = storage_tp.get_data_size();
+  if (codes_id == storage_tp.get_id() && (stride == itemsize || size <= 1) &&
+      !(codes.get_flags() & nd::write_access_flag)) {
+    // The codes can be used as they are. Codes which can still be written,
+    // through this array or another view of its memory, are copied instead,
+    // since a later out of range code would index past the categories.
+    return nd::make_strided_array_from_data(cat_tp, 1, &size, &itemsize,
+                                            nd::read_access_flag | (codes.get_flags() & nd::immutable_access_flag),
+                                            const_cast<char *>(codes.cdata()),
+                                            nd::memory_block(codes.get_data_memblock().get(), true), NULL);
+  }
+
+  nd::array result = make_strided_array(cat_tp, 1, &size);
+  char *dst = result.data();
+  src = codes.cdata();
+  for (intptr_t i = 0; i < size; ++i, src += stride, dst += itemsize) {
+    int64_t code;
+    read_code(codes_id, src, code);
+    uint32_t value = static_cast<uint32_t>(code);
+    switch (itemsize) {
+    case 1:
+      *reinterpret_cast<uint8_t *>(dst) = static_cast<uint8_t>(value);
+      break;
+    case 2:
+      *reinterpret_cast<uint16_t *>(dst) = static_cast<uint16_t>(value);
+      break;
+    default:
+      *reinterpret_cast<uint32_t *>(dst) = value;
+      break;
+    }
+  }
+  return result;
+}
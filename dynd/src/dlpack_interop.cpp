@@ -0,0 +1,265 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <Python.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <dynd/memblock/external_memory_block.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+#include "dlpack_interop.hpp"
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+bool make_dlpack_dtype(type_id_t id, DLDataType &out_dtype)
+{
+  out_dtype.lanes = 1;
+  switch (id) {
+  case bool_id:
+    out_dtype.code = kDLBool;
+    out_dtype.bits = 8;
+    return true;
+  case int8_id:
+  case int16_id:
+  case int32_id:
+  case int64_id:
+    out_dtype.code = kDLInt;
+    break;
+  case uint8_id:
+  case uint16_id:
+  case uint32_id:
+  case uint64_id:
+    out_dtype.code = kDLUInt;
+    break;
+  case float16_id:
+  case float32_id:
+  case float64_id:
+    out_dtype.code = kDLFloat;
+    break;
+  case complex_float32_id:
+  case complex_float64_id:
+    out_dtype.code = kDLComplex;
+    break;
+  default:
+    return false;
+  }
+  out_dtype.bits = static_cast<uint8_t>(8 * ndt::type(id).get_data_size());
+  return true;
+}
+
+ndt::type make_type_from_dlpack_dtype(const DLDataType &dtype)
+{
+  if (dtype.lanes == 1) {
+    switch (dtype.code) {
+    case kDLBool:
+      if (dtype.bits == 8) {
+        return ndt::type(bool_id);
+      }
+      break;
+    case kDLInt:
+      switch (dtype.bits) {
+      case 8:
+        return ndt::type(int8_id);
+      case 16:
+        return ndt::type(int16_id);
+      case 32:
+        return ndt::type(int32_id);
+      case 64:
+        return ndt::type(int64_id);
+      }
+      break;
+    case kDLUInt:
+      switch (dtype.bits) {
+      case 8:
+        return ndt::type(uint8_id);
+      case 16:
+        return ndt::type(uint16_id);
+      case 32:
+        return ndt::type(uint32_id);
+      case 64:
+        return ndt::type(uint64_id);
+      }
+      break;
+    case kDLFloat:
+      switch (dtype.bits) {
+      case 16:
+        return ndt::type(float16_id);
+      case 32:
+        return ndt::type(float32_id);
+      case 64:
+        return ndt::type(float64_id);
+      }
+      break;
+    case kDLComplex:
+      switch (dtype.bits) {
+      case 64:
+        return ndt::type(complex_float32_id);
+      case 128:
+        return ndt::type(complex_float64_id);
+      }
+      break;
+    }
+  }
+
+  stringstream ss;
+  ss << "cannot view DLPack dtype (code " << static_cast<int>(dtype.code) << ", bits " << static_cast<int>(dtype.bits)
+     << ", lanes " << dtype.lanes << ") as a dynd type";
+  throw dynd::type_error(ss.str());
+}
+
+/**
+ * Owns everything a tensor exported by dynd points at.
+ */
+struct exported_tensor {
+  nd::array keepalive;
+  std::vector<int64_t> shape;
+  std::vector<int64_t> strides;
+  DLManagedTensor tensor;
+};
+
+void delete_exported_tensor(DLManagedTensor *self) { delete static_cast<exported_tensor *>(self->manager_ctx); }
+
+void release_dlpack_capsule(PyObject *capsule)
+{
+  // A consumer renames the capsule to "used_dltensor", and then it is
+  // responsible for calling the deleter
+  if (PyCapsule_IsValid(capsule, "dltensor")) {
+    DLManagedTensor *tensor = static_cast<DLManagedTensor *>(PyCapsule_GetPointer(capsule, "dltensor"));
+    if (tensor->deleter != NULL) {
+      tensor->deleter(tensor);
+    }
+  }
+}
+
+void delete_imported_tensor(void *ptr)
+{
+  DLManagedTensor *tensor = static_cast<DLManagedTensor *>(ptr);
+  if (tensor->deleter != NULL) {
+    tensor->deleter(tensor);
+  }
+}
+
+} // anonymous namespace
+
+PyObject *pydynd::array_as_dlpack(const nd::array &a)
+{
+  exported_tensor *ctx = new exported_tensor;
+  try {
+    ctx->keepalive = a;
+    ndt::type tp = a.get_type();
+    const char *arrmeta = a.get()->metadata();
+    while (tp.get_id() == fixed_dim_id) {
+      const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(arrmeta);
+      ctx->shape.push_back(ss->dim_size);
+      ctx->strides.push_back(ss->stride);
+      tp = tp.extended<ndt::fixed_dim_type>()->get_element_type();
+      arrmeta += sizeof(size_stride_t);
+    }
+
+    DLTensor &t = ctx->tensor.dl_tensor;
+    if (!make_dlpack_dtype(tp.get_id(), t.dtype)) {
+      stringstream ss;
+      ss << "cannot export dynd type " << a.get_type()
+         << " through DLPack, it requires fixed dimensions of a numeric type";
+      throw dynd::type_error(ss.str());
+    }
+    // DLPack strides count elements rather than bytes
+    intptr_t itemsize = tp.get_data_size();
+    for (size_t i = 0; i < ctx->strides.size(); ++i) {
+      if (ctx->strides[i] % itemsize != 0) {
+        stringstream ss;
+        ss << "cannot export array of type " << a.get_type() << " through DLPack, its stride " << ctx->strides[i]
+           << " is not a multiple of the element size";
+        throw dynd::type_error(ss.str());
+      }
+      ctx->strides[i] /= itemsize;
+    }
+
+    t.data = const_cast<char *>(a.cdata());
+    t.device.device_type = kDLCPU;
+    t.device.device_id = 0;
+    t.ndim = static_cast<int32_t>(ctx->shape.size());
+    t.shape = ctx->shape.empty() ? NULL : ctx->shape.data();
+    t.strides = ctx->strides.empty() ? NULL : ctx->strides.data();
+    t.byte_offset = 0;
+    ctx->tensor.manager_ctx = ctx;
+    ctx->tensor.deleter = &delete_exported_tensor;
+  }
+  catch (...) {
+    delete ctx;
+    throw;
+  }
+
+  PyObject *capsule = PyCapsule_New(&ctx->tensor, "dltensor", &release_dlpack_capsule);
+  if (capsule == NULL) {
+    delete ctx;
+    throw exception();
+  }
+  return capsule;
+}
+
+nd::array pydynd::array_from_dlpack(PyObject *capsule)
+{
+  DLManagedTensor *tensor = static_cast<DLManagedTensor *>(PyCapsule_GetPointer(capsule, "dltensor"));
+  if (tensor == NULL) {
+    throw exception();
+  }
+  const DLTensor &t = tensor->dl_tensor;
+  if (t.device.device_type != kDLCPU && t.device.device_type != kDLCUDAHost) {
+    stringstream ss;
+    ss << "cannot view DLPack tensor on device type " << static_cast<int>(t.device.device_type)
+       << ", dynd arrays must be in CPU memory";
+    throw invalid_argument(ss.str());
+  }
+
+  ndt::type tp = make_type_from_dlpack_dtype(t.dtype);
+  intptr_t itemsize = tp.get_data_size();
+  intptr_t ndim = t.ndim;
+  std::vector<intptr_t> shape(t.shape, t.shape + ndim);
+  std::vector<intptr_t> strides(ndim);
+  if (t.strides != NULL) {
+    for (intptr_t i = 0; i < ndim; ++i) {
+      strides[i] = static_cast<intptr_t>(t.strides[i]) * itemsize;
+    }
+  }
+  else {
+    // No strides means a C contiguous tensor
+    intptr_t stride = itemsize;
+    for (intptr_t i = ndim - 1; i >= 0; --i) {
+      strides[i] = stride;
+      stride *= shape[i];
+    }
+  }
+  char *data = static_cast<char *>(t.data) + t.byte_offset;
+
+  // DyND kernels assume aligned data
+  size_t alignment = tp.get_data_alignment();
+  bool aligned = (reinterpret_cast<uintptr_t>(data) & (alignment - 1)) == 0;
+  for (intptr_t i = 0; i < ndim; ++i) {
+    aligned = aligned && (static_cast<uintptr_t>(strides[i]) & (alignment - 1)) == 0;
+  }
+  if (!aligned) {
+    stringstream ss;
+    ss << "cannot view unaligned DLPack tensor data as dynd type " << tp;
+    throw runtime_error(ss.str());
+  }
+
+  // Consume the capsule, from here on the memory block calls the deleter
+  if (PyCapsule_SetName(capsule, "used_dltensor") < 0) {
+    throw exception();
+  }
+  nd::memory_block memblock =
+      nd::make_memory_block<nd::external_memory_block>(reinterpret_cast<void *>(tensor), &delete_imported_tensor);
+
+  return nd::make_strided_array_from_data(tp, ndim, shape.data(), strides.data(),
+                                          nd::read_access_flag | nd::write_access_flag, data,
+                                          nd::memory_block(std::move(memblock).get(), true), NULL);
+}
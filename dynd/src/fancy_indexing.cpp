@@ -0,0 +1,291 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <Python.h>
+
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <dynd/exceptions.hpp>
+#include <dynd/shape_tools.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+#include "array_functions.hpp"
+#include "fancy_indexing.hpp"
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * `size` consecutive rows starting at row `src` of the indexed array,
+ * which are rows `dst` onwards of the gathered result. Sorted indices
+ * and masks with long true stretches become a few long runs, which are
+ * copied in bulk.
+ */
+struct index_run {
+  intptr_t src;
+  intptr_t dst;
+  intptr_t size;
+};
+
+inline void add_to_runs(std::vector<index_run> &runs, intptr_t src, intptr_t dst)
+{
+  if (!runs.empty() && runs.back().src + runs.back().size == src) {
+    ++runs.back().size;
+  }
+  else {
+    index_run run = {src, dst, 1};
+    runs.push_back(run);
+  }
+}
+
+template <typename T>
+void make_runs_from_indices(const char *data, intptr_t stride, intptr_t count, intptr_t dim_size,
+                            std::vector<index_run> &runs)
+{
+  for (intptr_t k = 0; k < count; ++k, data += stride) {
+    T raw = *reinterpret_cast<const T *>(data);
+    intptr_t i = static_cast<intptr_t>(raw);
+    if (numeric_limits<T>::is_signed && i < 0) {
+      i += dim_size;
+    }
+    if (i < 0 || i >= dim_size) {
+      throw index_out_of_bounds(static_cast<intptr_t>(raw), dim_size);
+    }
+    add_to_runs(runs, i, k);
+  }
+}
+
+void make_runs_from_mask(const char *data, intptr_t stride, intptr_t dim_size, std::vector<index_run> &runs)
+{
+  intptr_t count = 0;
+  for (intptr_t i = 0; i < dim_size; ++i, data += stride) {
+    if (*data != 0) {
+      add_to_runs(runs, i, count++);
+    }
+  }
+}
+
+/**
+ * Converts an index array into runs of rows, returning the number of
+ * selected rows.
+ */
+intptr_t make_index_runs(const nd::array &index, intptr_t dim_size, std::vector<index_run> &runs)
+{
+  if (!pydynd::array_is_index_array(index)) {
+    stringstream ss;
+    ss << "an index array must be a 1D array of integers or bools, not " << index.get_type();
+    throw dynd::type_error(ss.str());
+  }
+  const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(index.get()->metadata());
+  const char *data = index.cdata();
+  switch (index.get_dtype().get_id()) {
+  case bool_id:
+    if (ss->dim_size != dim_size) {
+      stringstream msg;
+      msg << "boolean index of size " << ss->dim_size << " does not match the dimension of size " << dim_size;
+      throw out_of_range(msg.str());
+    }
+    make_runs_from_mask(data, ss->stride, dim_size, runs);
+    break;
+  case int8_id:
+    make_runs_from_indices<int8_t>(data, ss->stride, ss->dim_size, dim_size, runs);
+    break;
+  case int16_id:
+    make_runs_from_indices<int16_t>(data, ss->stride, ss->dim_size, dim_size, runs);
+    break;
+  case int32_id:
+    make_runs_from_indices<int32_t>(data, ss->stride, ss->dim_size, dim_size, runs);
+    break;
+  case int64_id:
+    make_runs_from_indices<int64_t>(data, ss->stride, ss->dim_size, dim_size, runs);
+    break;
+  case uint8_id:
+    make_runs_from_indices<uint8_t>(data, ss->stride, ss->dim_size, dim_size, runs);
+    break;
+  case uint16_id:
+    make_runs_from_indices<uint16_t>(data, ss->stride, ss->dim_size, dim_size, runs);
+    break;
+  case uint32_id:
+    make_runs_from_indices<uint32_t>(data, ss->stride, ss->dim_size, dim_size, runs);
+    break;
+  case uint64_id:
+    make_runs_from_indices<uint64_t>(data, ss->stride, ss->dim_size, dim_size, runs);
+    break;
+  default:
+    break;
+  }
+  return runs.empty() ? 0 : runs.back().dst + runs.back().size;
+}
+
+/**
+ * Returns the element type of the outermost fixed dimension of `a`,
+ * with its size and stride.
+ */
+ndt::type get_outer_fixed_dim(const nd::array &a, intptr_t &out_dim_size, intptr_t &out_stride)
+{
+  if (a.get_type().get_id() != fixed_dim_id) {
+    stringstream ss;
+    ss << "indexing by an array requires an outermost fixed dimension, not " << a.get_type();
+    throw dynd::type_error(ss.str());
+  }
+  const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(a.get()->metadata());
+  out_dim_size = ss->dim_size;
+  out_stride = ss->stride;
+  return a.get_type().extended<ndt::fixed_dim_type>()->get_element_type();
+}
+
+/**
+ * If the rows of type `row_tp` are C contiguous arrays of a builtin type,
+ * so can be copied as plain bytes, returns their size, otherwise -1.
+ */
+intptr_t get_pod_row_size(ndt::type row_tp, const char *arrmeta)
+{
+  std::vector<intptr_t> shape, strides;
+  while (row_tp.get_id() == fixed_dim_id) {
+    const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(arrmeta);
+    shape.push_back(ss->dim_size);
+    strides.push_back(ss->stride);
+    arrmeta += sizeof(size_stride_t);
+    row_tp = row_tp.extended<ndt::fixed_dim_type>()->get_element_type();
+  }
+  if (!row_tp.is_builtin()) {
+    return -1;
+  }
+  intptr_t row_size = row_tp.get_data_size();
+  if (!strides_are_c_contiguous(static_cast<intptr_t>(shape.size()), row_size, shape.data(), strides.data())) {
+    return -1;
+  }
+  for (size_t i = 0; i < shape.size(); ++i) {
+    row_size *= shape[i];
+  }
+  return row_size;
+}
+
+/**
+ * Copies `size` rows of `row_size` bytes, which are `dst_stride` and
+ * `src_stride` apart, in one memcpy when both sides are contiguous.
+ */
+inline void copy_rows(char *dst, intptr_t dst_stride, const char *src, intptr_t src_stride, intptr_t size,
+                      intptr_t row_size)
+{
+  if ((dst_stride == row_size && src_stride == row_size) || size == 1) {
+    memcpy(dst, src, size * row_size);
+  }
+  else {
+    for (intptr_t j = 0; j < size; ++j) {
+      memcpy(dst + j * dst_stride, src + j * src_stride, row_size);
+    }
+  }
+}
+
+inline nd::array get_rows(const nd::array &a, intptr_t begin, intptr_t size)
+{
+  irange r(begin, begin + size);
+  return a.at_array(1, &r, false);
+}
+
+} // anonymous namespace
+
+bool pydynd::array_is_index_array(const nd::array &index)
+{
+  if (index.is_null() || index.get_type().get_id() != fixed_dim_id || index.get_ndim() != 1) {
+    return false;
+  }
+  switch (index.get_dtype().get_id()) {
+  case bool_id:
+  case int8_id:
+  case int16_id:
+  case int32_id:
+  case int64_id:
+  case uint8_id:
+  case uint16_id:
+  case uint32_id:
+  case uint64_id:
+    return true;
+  default:
+    return false;
+  }
+}
+
+nd::array pydynd::array_take(const nd::array &a, const nd::array &index)
+{
+  intptr_t dim_size, stride;
+  ndt::type row_tp = get_outer_fixed_dim(a, dim_size, stride);
+  std::vector<index_run> runs;
+  intptr_t count = make_index_runs(index, dim_size, runs);
+
+  intptr_t row_size = get_pod_row_size(row_tp, a.get()->metadata() + sizeof(size_stride_t));
+  if (row_size >= 0) {
+    // Gather plain bytes straight into a C contiguous result
+    intptr_t ndim = a.get_ndim();
+    dimvector shape(ndim);
+    a.get_shape(shape.get());
+    shape[0] = count;
+    nd::array result = make_strided_array(a.get_dtype(), ndim, shape.get());
+    char *dst = result.data();
+    const char *src = a.cdata();
+    for (size_t i = 0; i < runs.size(); ++i) {
+      const index_run &run = runs[i];
+      copy_rows(dst + run.dst * row_size, row_size, src + run.src * stride, stride, run.size, row_size);
+    }
+    return result;
+  }
+
+  // Otherwise assign a run of rows at a time
+  nd::array result = make_strided_array(row_tp, 1, &count);
+  for (size_t i = 0; i < runs.size(); ++i) {
+    const index_run &run = runs[i];
+    get_rows(result, run.dst, run.size).assign(get_rows(a, run.src, run.size));
+  }
+  return result;
+}
+
+void pydynd::array_put(const nd::array &a, const nd::array &index, const nd::array &value)
+{
+  intptr_t dim_size, stride;
+  ndt::type row_tp = get_outer_fixed_dim(a, dim_size, stride);
+  if ((a.get_flags() & nd::write_access_flag) == 0) {
+    throw runtime_error("tried to write to a dynd array that is not writable");
+  }
+  std::vector<index_run> runs;
+  intptr_t count = make_index_runs(index, dim_size, runs);
+
+  // The value either has a row for every selected row, or is broadcast
+  bool value_per_row = value.get_type().get_id() == fixed_dim_id && value.get_ndim() == a.get_ndim() &&
+                       value.get_dim_size() == count;
+  if (value_per_row && value.get_dtype() == a.get_dtype()) {
+    const char *arrmeta = a.get()->metadata() + sizeof(size_stride_t);
+    const char *value_arrmeta = value.get()->metadata() + sizeof(size_stride_t);
+    intptr_t row_size = get_pod_row_size(row_tp, arrmeta);
+    if (row_size >= 0 && get_pod_row_size(value.get_type().extended<ndt::fixed_dim_type>()->get_element_type(),
+                                          value_arrmeta) == row_size) {
+      // Scatter plain bytes
+      intptr_t value_stride = reinterpret_cast<const size_stride_t *>(value.get()->metadata())->stride;
+      char *dst = a.data();
+      const char *src = value.cdata();
+      for (size_t i = 0; i < runs.size(); ++i) {
+        const index_run &run = runs[i];
+        copy_rows(dst + run.src * stride, stride, src + run.dst * value_stride, value_stride, run.size, row_size);
+      }
+      return;
+    }
+  }
+
+  for (size_t i = 0; i < runs.size(); ++i) {
+    const index_run &run = runs[i];
+    if (value_per_row) {
+      get_rows(a, run.src, run.size).assign(get_rows(value, run.dst, run.size));
+    }
+    else {
+      get_rows(a, run.src, run.size).assign(value);
+    }
+  }
+}
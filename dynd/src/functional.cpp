@@ -10,9 +10,9 @@
 using namespace std;
 using namespace dynd;
 
-nd::callable apply(const ndt::type &tp, PyObject *func)
+nd::callable apply(const ndt::type &tp, PyObject *func, bool batch)
 {
-  return nd::make_callable<pydynd::nd::functional::apply_pyobject_callable>(tp, func);
+  return nd::make_callable<pydynd::nd::functional::apply_pyobject_callable>(tp, func, batch);
 }
 
 dynd::nd::callable &dynd_nd_callable_to_cpp_ref(PyObject *o)
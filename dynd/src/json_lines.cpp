@@ -0,0 +1,239 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <Python.h>
+
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include <dynd/json_parser.hpp>
+#include <dynd/types/base_dim_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/tuple_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+#include "array_functions.hpp"
+#include "json_lines.hpp"
+#include "thread_pool.hpp"
+#include "utility_functions.hpp"
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+inline bool is_blank(const char *begin, const char *end)
+{
+  for (; begin != end; ++begin) {
+    if (*begin != ' ' && *begin != '\t' && *begin != '\r' && *begin != '\n') {
+      return false;
+    }
+  }
+  return true;
+}
+
+intptr_t count_json_lines(const char *begin, const char *end)
+{
+  intptr_t count = 0;
+  while (begin != end) {
+    const char *line_end = static_cast<const char *>(memchr(begin, '\n', end - begin));
+    if (line_end == NULL) {
+      line_end = end;
+    }
+    if (!is_blank(begin, line_end)) {
+      ++count;
+    }
+    begin = (line_end == end) ? end : line_end + 1;
+  }
+  return count;
+}
+
+bool type_contains_var_dim(const ndt::type &tp)
+{
+  switch (tp.get_id()) {
+  case var_dim_id:
+    return true;
+  case fixed_dim_id:
+    return type_contains_var_dim(tp.extended<ndt::fixed_dim_type>()->get_element_type());
+  case option_id:
+    return type_contains_var_dim(tp.extended<ndt::option_type>()->get_value_type());
+  case tuple_id:
+  case struct_id: {
+    const ndt::tuple_type *tt = tp.extended<ndt::tuple_type>();
+    for (intptr_t i = 0; i < tt->get_field_count(); ++i) {
+      if (type_contains_var_dim(tt->get_field_type(i))) {
+        return true;
+      }
+    }
+    return false;
+  }
+  default:
+    return false;
+  }
+}
+
+/**
+ * Splits [begin, end) into about `nchunks` chunks which end at line
+ * boundaries, returning the chunk boundaries.
+ */
+std::vector<const char *> split_json_lines(const char *begin, const char *end, intptr_t nchunks)
+{
+  std::vector<const char *> bounds(1, begin);
+  intptr_t chunk_size = (end - begin + nchunks - 1) / nchunks;
+  const char *pos = begin;
+  while (pos != end) {
+    const char *next = (end - pos > chunk_size) ? pos + chunk_size : end;
+    if (next != end) {
+      next = static_cast<const char *>(memchr(next, '\n', end - next));
+      next = (next == NULL) ? end : next + 1;
+    }
+    bounds.push_back(next);
+    pos = next;
+  }
+  return bounds;
+}
+
+/**
+ * Returns the index of the first row of each chunk between `bounds`,
+ * followed by the total number of rows.
+ */
+std::vector<intptr_t> count_chunk_rows(const std::vector<const char *> &bounds, intptr_t nthreads)
+{
+  intptr_t nchunks = static_cast<intptr_t>(bounds.size()) - 1;
+  std::vector<intptr_t> row_offsets(nchunks + 1, 0);
+  {
+    pydynd::PyAllowThreads_RAII pat;
+    pydynd::get_thread_pool().parallel_for(nchunks, 1, nthreads, [&](intptr_t chunk_begin, intptr_t chunk_end) {
+      for (intptr_t k = chunk_begin; k < chunk_end; ++k) {
+        row_offsets[k + 1] = count_json_lines(bounds[k], bounds[k + 1]);
+      }
+    });
+  }
+  for (intptr_t k = 0; k < nchunks; ++k) {
+    row_offsets[k + 1] += row_offsets[k];
+  }
+  return row_offsets;
+}
+
+/**
+ * Parses each chunk between `bounds` into the rows of `out` starting at
+ * its entry in `row_offsets`.
+ */
+void parse_json_chunks(const nd::array &out, const std::vector<const char *> &bounds,
+                       const std::vector<intptr_t> &row_offsets, intptr_t nthreads)
+{
+  intptr_t nchunks = static_cast<intptr_t>(bounds.size()) - 1;
+  pydynd::PyAllowThreads_RAII pat;
+  pydynd::get_thread_pool().parallel_for(nchunks, 1, nthreads, [&](intptr_t chunk_begin, intptr_t chunk_end) {
+    for (intptr_t k = chunk_begin; k < chunk_end; ++k) {
+      intptr_t consumed = 0;
+      pydynd::parse_json_lines(out, row_offsets[k], bounds[k], bounds[k + 1], true, &consumed);
+    }
+  });
+}
+
+void check_json_record_count(intptr_t count, intptr_t dim_size)
+{
+  if (count != dim_size) {
+    stringstream ss;
+    ss << "the JSON has " << count << " records, but the output has " << dim_size << " rows";
+    throw invalid_argument(ss.str());
+  }
+}
+
+intptr_t get_json_chunk_count(intptr_t nthreads, const ndt::type &el_tp)
+{
+  // Several chunks per thread balance out records of different lengths
+  return type_contains_var_dim(el_tp) ? 1 : 4 * nthreads;
+}
+
+} // anonymous namespace
+
+intptr_t pydynd::parse_json_lines(const nd::array &out, intptr_t start_row, const char *begin, const char *end,
+                                  bool final, intptr_t *out_consumed)
+{
+  if (out.get_type().get_id() != fixed_dim_id) {
+    stringstream ss;
+    ss << "parsing JSON lines requires an output array with an outermost fixed dimension, not " << out.get_type();
+    throw dynd::type_error(ss.str());
+  }
+  intptr_t dim_size = reinterpret_cast<const size_stride_t *>(out.get()->metadata())->dim_size;
+
+  intptr_t row = start_row;
+  const char *pos = begin;
+  while (pos != end && row < dim_size) {
+    const char *line_end = static_cast<const char *>(memchr(pos, '\n', end - pos));
+    const char *next;
+    if (line_end == NULL) {
+      if (!final) {
+        // An incomplete line, which the next block will finish
+        break;
+      }
+      line_end = end;
+      next = end;
+    }
+    else {
+      next = line_end + 1;
+    }
+    if (!is_blank(pos, line_end)) {
+      nd::array out_row = out(row);
+      parse_json(out_row, pos, line_end, &eval::default_eval_context);
+      ++row;
+    }
+    pos = next;
+  }
+
+  *out_consumed = pos - begin;
+  return row - start_row;
+}
+
+nd::array pydynd::parse_json_lines_parallel(const ndt::type &tp, const char *begin, const char *end, intptr_t nthreads)
+{
+  if (tp.get_id() != fixed_dim_id && tp.get_id() != var_dim_id) {
+    stringstream ss;
+    ss << "parsing JSON lines requires a var or fixed dimension type, not " << tp;
+    throw dynd::type_error(ss.str());
+  }
+  ndt::type el_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+  if (nthreads <= 0) {
+    nthreads = pydynd::thread_pool::default_nthreads();
+  }
+
+  std::vector<const char *> bounds = split_json_lines(begin, end, get_json_chunk_count(nthreads, el_tp));
+  std::vector<intptr_t> row_offsets = count_chunk_rows(bounds, nthreads);
+  intptr_t count = row_offsets.back();
+  if (tp.get_id() == fixed_dim_id) {
+    check_json_record_count(count, tp.extended<ndt::fixed_dim_type>()->get_fixed_dim_size());
+  }
+
+  nd::array result = pydynd::make_strided_array(el_tp, 1, &count);
+  parse_json_chunks(result, bounds, row_offsets, nthreads);
+  if (tp.get_id() == var_dim_id) {
+    nd::array var_result = nd::empty(tp);
+    var_result.assign(result);
+    return var_result;
+  }
+  return result;
+}
+
+void pydynd::parse_json_lines_parallel(const nd::array &out, const char *begin, const char *end, intptr_t nthreads)
+{
+  if (out.get_type().get_id() != fixed_dim_id) {
+    stringstream ss;
+    ss << "parsing JSON lines in parallel requires an output array with an outermost fixed dimension, not "
+       << out.get_type();
+    throw dynd::type_error(ss.str());
+  }
+  if (nthreads <= 0) {
+    nthreads = pydynd::thread_pool::default_nthreads();
+  }
+  ndt::type el_tp = out.get_type().extended<ndt::fixed_dim_type>()->get_element_type();
+  std::vector<const char *> bounds = split_json_lines(begin, end, get_json_chunk_count(nthreads, el_tp));
+  std::vector<intptr_t> row_offsets = count_chunk_rows(bounds, nthreads);
+  check_json_record_count(row_offsets.back(), reinterpret_cast<const size_stride_t *>(out.get()->metadata())->dim_size);
+  parse_json_chunks(out, bounds, row_offsets, nthreads);
+}
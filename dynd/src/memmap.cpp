@@ -0,0 +1,268 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <Python.h>
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <dynd/memblock/external_memory_block.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+#include "memmap.hpp"
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+// The header is
+//   char magic[8];          "DYNDMMAP"
+//   uint32_t version;       1
+//   uint32_t header_size;   the offset of the data, a multiple of 64
+//   uint32_t byte_order;    0x01020304 as written by the creating machine
+//   uint32_t type_size;     the length of the type's datashape
+//   char type[type_size];   the datashape, followed by zero padding
+const char memmap_magic[8] = {'D', 'Y', 'N', 'D', 'M', 'M', 'A', 'P'};
+const uint32_t memmap_version = 1;
+const uint32_t memmap_byte_order = 0x01020304;
+const size_t memmap_fixed_header_size = 24;
+const size_t memmap_header_alignment = 64;
+
+struct mapped_file {
+  void *addr;
+  size_t size;
+#if defined(_WIN32)
+  HANDLE mapping;
+#endif
+};
+
+void unmap_file(void *ptr)
+{
+  mapped_file *mf = static_cast<mapped_file *>(ptr);
+#if defined(_WIN32)
+  UnmapViewOfFile(mf->addr);
+  CloseHandle(mf->mapping);
+#else
+  munmap(mf->addr, mf->size);
+#endif
+  delete mf;
+}
+
+void throw_file_error(const string &path)
+{
+#if defined(_WIN32)
+  PyErr_SetExcFromWindowsErrWithFilename(PyExc_OSError, 0, path.c_str());
+#else
+  PyErr_SetFromErrnoWithFilename(PyExc_OSError, const_cast<char *>(path.c_str()));
+#endif
+  throw std::exception();
+}
+
+void throw_format_error(const string &path, const char *what)
+{
+  stringstream ss;
+  ss << "the file \"" << path << "\" is not a dynd memory-mapped array: " << what;
+  throw invalid_argument(ss.str());
+}
+
+void check_memmap_type(const ndt::type &tp)
+{
+  ndt::type el_tp = tp;
+  while (el_tp.get_id() == fixed_dim_id) {
+    el_tp = el_tp.extended<ndt::fixed_dim_type>()->get_element_type();
+  }
+  bool ok = el_tp.get_ndim() == 0 && el_tp.get_arrmeta_size() == 0 && el_tp.get_data_size() > 0 &&
+            (el_tp.is_builtin() || el_tp.get_id() == fixed_bytes_id || el_tp.get_id() == fixed_string_id);
+  if (!ok) {
+    stringstream ss;
+    ss << "a memory-mapped array requires fixed dimensions of a number or fixed-size string or bytes, not " << tp;
+    throw dynd::type_error(ss.str());
+  }
+}
+
+vector<char> make_header(const ndt::type &tp)
+{
+  stringstream ss;
+  ss << tp;
+  string type_str = ss.str();
+
+  size_t size = memmap_fixed_header_size + type_str.size();
+  size = (size + memmap_header_alignment - 1) / memmap_header_alignment * memmap_header_alignment;
+  vector<char> header(size, 0);
+  uint32_t fields[4] = {memmap_version, static_cast<uint32_t>(size), memmap_byte_order,
+                        static_cast<uint32_t>(type_str.size())};
+  memcpy(&header[0], memmap_magic, sizeof(memmap_magic));
+  memcpy(&header[8], fields, sizeof(fields));
+  memcpy(&header[memmap_fixed_header_size], type_str.data(), type_str.size());
+  return header;
+}
+
+/**
+ * Reads the header from the start of an existing file, returning the
+ * type, and the offset of the data in `out_header_size`.
+ */
+ndt::type read_header(const string &path, size_t &out_header_size)
+{
+  FILE *f = fopen(path.c_str(), "rb");
+  if (f == NULL) {
+    throw_file_error(path);
+  }
+  char fixed[memmap_fixed_header_size];
+  uint32_t fields[4] = {0, 0, 0, 0};
+  bool has_magic =
+      fread(fixed, 1, sizeof(fixed), f) == sizeof(fixed) && memcmp(fixed, memmap_magic, sizeof(memmap_magic)) == 0;
+  if (has_magic) {
+    memcpy(fields, fixed + sizeof(memmap_magic), sizeof(fields));
+  }
+  string type_str;
+  bool ok = has_magic && fields[0] == memmap_version && fields[2] == memmap_byte_order && fields[3] > 0 &&
+            memmap_fixed_header_size + fields[3] <= fields[1];
+  if (ok) {
+    type_str.resize(fields[3]);
+    ok = fread(&type_str[0], 1, fields[3], f) == fields[3];
+  }
+  fclose(f);
+
+  if (!ok) {
+    if (has_magic && fields[2] != memmap_byte_order) {
+      throw_format_error(path, "it was written with a different byte order");
+    }
+    throw_format_error(path, "the header is missing or invalid");
+  }
+  out_header_size = fields[1];
+  return ndt::type(type_str);
+}
+
+} // anonymous namespace
+
+nd::array pydynd::array_memmap(const string &path, const ndt::type &tp, const string &mode)
+{
+  bool create = (mode == "w+");
+  bool writable = (mode == "r+" || mode == "c" || create);
+  if (!create && mode != "r" && mode != "r+" && mode != "c") {
+    stringstream ss;
+    ss << "invalid memmap mode \"" << mode << "\", expected \"r\", \"r+\", \"c\" or \"w+\"";
+    throw invalid_argument(ss.str());
+  }
+
+  ndt::type array_tp = tp;
+  vector<char> header;
+  size_t header_size;
+  if (create) {
+    if (tp.get_id() == uninitialized_id) {
+      throw invalid_argument("creating a memory-mapped array requires a type");
+    }
+    check_memmap_type(tp);
+    header = make_header(tp);
+    header_size = header.size();
+  }
+  else {
+    array_tp = read_header(path, header_size);
+    if (tp.get_id() != uninitialized_id && tp != array_tp) {
+      stringstream ss;
+      ss << "the memory-mapped file \"" << path << "\" has type " << array_tp << ", not " << tp;
+      throw dynd::type_error(ss.str());
+    }
+    check_memmap_type(array_tp);
+  }
+  size_t data_size = array_tp.get_data_size();
+  size_t file_size = header_size + data_size;
+
+  mapped_file *mf = new mapped_file;
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | (writable && mode != "c" ? GENERIC_WRITE : 0),
+                            FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, create ? CREATE_ALWAYS : OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    delete mf;
+    throw_file_error(path);
+  }
+  LARGE_INTEGER existing_size;
+  if (!create && (!GetFileSizeEx(file, &existing_size) || static_cast<size_t>(existing_size.QuadPart) < file_size)) {
+    CloseHandle(file);
+    delete mf;
+    throw_format_error(path, "the file is shorter than its type requires");
+  }
+  DWORD protect = (mode == "r") ? PAGE_READONLY : (mode == "c" ? PAGE_WRITECOPY : PAGE_READWRITE);
+  mf->mapping = CreateFileMappingA(file, NULL, protect, static_cast<DWORD>(static_cast<uint64_t>(file_size) >> 32),
+                                   static_cast<DWORD>(file_size), NULL);
+  CloseHandle(file);
+  if (mf->mapping == NULL) {
+    delete mf;
+    throw_file_error(path);
+  }
+  DWORD access = (mode == "r") ? FILE_MAP_READ : (mode == "c" ? FILE_MAP_COPY : FILE_MAP_WRITE);
+  mf->addr = MapViewOfFile(mf->mapping, access, 0, 0, file_size);
+  if (mf->addr == NULL) {
+    CloseHandle(mf->mapping);
+    delete mf;
+    throw_file_error(path);
+  }
+#else
+  int fd = open(path.c_str(), create ? (O_RDWR | O_CREAT | O_TRUNC) : (mode == "r+" ? O_RDWR : O_RDONLY), 0666);
+  if (fd < 0) {
+    delete mf;
+    throw_file_error(path);
+  }
+  struct stat st;
+  if (create) {
+    // Extending the file with ftruncate leaves the data as zeros without
+    // writing it out
+    if (ftruncate(fd, static_cast<off_t>(file_size)) != 0) {
+      close(fd);
+      delete mf;
+      throw_file_error(path);
+    }
+  }
+  else if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < file_size) {
+    close(fd);
+    delete mf;
+    throw_format_error(path, "the file is shorter than its type requires");
+  }
+  int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+  mf->addr = mmap(NULL, file_size, prot, mode == "c" ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+  close(fd);
+  if (mf->addr == MAP_FAILED) {
+    delete mf;
+    throw_file_error(path);
+  }
+#endif
+  mf->size = file_size;
+  if (create) {
+    memcpy(mf->addr, &header[0], header_size);
+  }
+  nd::memory_block memblock = nd::make_memory_block<nd::external_memory_block>(reinterpret_cast<void *>(mf), &unmap_file);
+
+  // The data is C-contiguous after the header
+  intptr_t ndim = array_tp.get_ndim();
+  vector<intptr_t> shape(ndim), strides(ndim);
+  ndt::type el_tp = array_tp;
+  for (intptr_t i = 0; i < ndim; ++i) {
+    shape[i] = el_tp.extended<ndt::fixed_dim_type>()->get_fixed_dim_size();
+    el_tp = el_tp.extended<ndt::fixed_dim_type>()->get_element_type();
+  }
+  intptr_t stride = el_tp.get_data_size();
+  for (intptr_t i = ndim - 1; i >= 0; --i) {
+    strides[i] = shape[i] > 1 ? stride : 0;
+    stride *= shape[i];
+  }
+
+  uint64_t flags = writable ? (nd::read_access_flag | nd::write_access_flag) : nd::read_access_flag;
+  return nd::make_strided_array_from_data(el_tp, ndim, shape.data(), strides.data(), flags,
+                                          static_cast<char *>(mf->addr) + header_size,
+                                          nd::memory_block(std::move(memblock).get(), true), NULL);
+}
@@ -9,6 +9,9 @@
 
 #include "types/pyobject_type.hpp"
 #include <dynd/types/any_kind_type.hpp>
+#include <dynd/types/base_dim_type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/tuple_type.hpp>
 
 using namespace dynd;
 
@@ -34,3 +37,30 @@ void pyobject_type::print_data(std::ostream &o, const char *arrmeta, const char
 }
 
 const type_id_t ndt::id_of<pyobject_type>::value = new_id("pyobject", any_kind_id);
+
+bool pydynd::type_contains_pyobject(const ndt::type &tp)
+{
+  if (tp.get_id() == ndt::id_of<pyobject_type>::value) {
+    return true;
+  }
+  if (tp.get_ndim() > 0) {
+    return type_contains_pyobject(tp.extended<ndt::base_dim_type>()->get_element_type());
+  }
+
+  switch (tp.get_id()) {
+  case option_id:
+    return type_contains_pyobject(tp.extended<ndt::option_type>()->get_value_type());
+  case tuple_id:
+  case struct_id: {
+    const ndt::tuple_type *tt = tp.extended<ndt::tuple_type>();
+    for (intptr_t i = 0; i < tt->get_field_count(); ++i) {
+      if (type_contains_pyobject(tt->get_field_type(i))) {
+        return true;
+      }
+    }
+    return false;
+  }
+  default:
+    return false;
+  }
+}
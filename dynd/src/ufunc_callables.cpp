@@ -0,0 +1,96 @@
+//
+// Copyright (C) 2011-15 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <memory>
+#include <sstream>
+
+#include <dynd/types/callable_type.hpp>
+
+#include "callables/scalar_ufunc_callable.hpp"
+#include "numpy_type_interop.hpp"
+#include "ufunc_callables.hpp"
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * Converts the type numbers of one loop to dynd types, returning false
+ * for a loop which uses a type dynd has no builtin equivalent for.
+ */
+bool get_loop_types(const char *type_nums, intptr_t nargs, vector<ndt::type> &out_types)
+{
+  out_types.clear();
+  for (intptr_t j = 0; j < nargs; ++j) {
+    switch (type_nums[j]) {
+    case NPY_OBJECT:
+    case NPY_LONGDOUBLE:
+    case NPY_CLONGDOUBLE:
+      // Object loops need the GIL, and dynd has no long double
+      return false;
+    default:
+      try {
+        out_types.push_back(pydynd::_type_from_numpy_type_num(type_nums[j]));
+      }
+      catch (const dynd::type_error &) {
+        return false;
+      }
+      break;
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+vector<dynd::nd::callable> pydynd::ufunc_loop_callables(PyObject *ufunc)
+{
+  if (!PyObject_TypeCheck(ufunc, &PyUFunc_Type)) {
+    throw dynd::type_error("expected a numpy.ufunc");
+  }
+  PyUFuncObject *uf = reinterpret_cast<PyUFuncObject *>(ufunc);
+  if (uf->nout != 1) {
+    stringstream ss;
+    ss << "only ufuncs with one output can be wrapped as callables, " << uf->name << " has " << uf->nout;
+    throw invalid_argument(ss.str());
+  }
+
+  intptr_t nargs = uf->nin + uf->nout;
+  vector<dynd::nd::callable> result;
+  vector<vector<ndt::type>> signatures;
+  vector<ndt::type> types;
+  for (intptr_t i = 0; i < uf->ntypes; ++i) {
+    if (!get_loop_types(uf->types + i * nargs, nargs, types)) {
+      continue;
+    }
+    bool seen = false;
+    for (size_t k = 0; k < signatures.size() && !seen; ++k) {
+      seen = signatures[k] == types;
+    }
+    if (seen) {
+      continue;
+    }
+    signatures.push_back(types);
+
+    shared_ptr<pydynd::nd::functional::scalar_ufunc_data> data =
+        make_shared<pydynd::nd::functional::scalar_ufunc_data>();
+    Py_INCREF(ufunc);
+    data->ufunc = uf;
+    data->funcptr = uf->functions[i];
+    data->ufunc_data = (uf->data == NULL) ? NULL : uf->data[i];
+    data->param_count = uf->nin;
+    for (intptr_t j = 0; j < nargs; ++j) {
+      data->item_size[j] = static_cast<intptr_t>(types[j].get_data_size());
+    }
+
+    ndt::type dst_tp = types[uf->nin];
+    vector<ndt::type> src_tp(types.begin(), types.begin() + uf->nin);
+    result.push_back(dynd::nd::make_callable<pydynd::nd::functional::scalar_ufunc_callable<false>>(
+        ndt::make_type<ndt::callable_type>(dst_tp, src_tp), dst_tp, data));
+  }
+
+  return result;
+}